@@ -1,6 +1,7 @@
 #include "async_evaluator.h"
 
 #include "objective.h"
+#include "tracer.h"
 
 namespace spot
 {
@@ -10,12 +11,22 @@ namespace spot
 		thread_prio_( thread_prio )
 	{}
 
-	std::future< xo::result< fitness_t > > async_evaluator::evaluate_async( const objective& o, const search_point& point, const xo::stop_token& st ) const
+	std::future< xo::result< fitness_t > > async_evaluator::evaluate_async( const objective& o, const search_point& point, const xo::stop_token& st, evaluator_metrics::task task, double* duration )
 	{
 		return std::async( std::launch::async,
-			[&]() {
+			[&, task, duration]() mutable -> xo::result< fitness_t > {
+				if ( st.stop_requested() )
+				{
+					metrics_.cancel_task( task );
+					*duration = 0;
+					return xo::error_message( evaluation_cancelled_message );
+				}
 				xo::set_thread_priority( thread_prio_ );
-				return o.evaluate_noexcept( point, st );
+				SPOT_TRACE_SCOPE( "evaluator::evaluate" );
+				metrics_.start_task( task );
+				auto result = o.evaluate_noexcept( point, st );
+				*duration = metrics_.finish_task( task, !result );
+				return result;
 			} );
 	}
 
@@ -30,12 +41,19 @@ namespace spot
 	{
 		vector< result<fitness_t> > results( point_vec.size() );
 		vector< pair< std::future< xo::result< fitness_t > >, index_t > > threads;
+		auto& durations = thread_evaluation_durations();
+		durations.resize( point_vec.size() );
 
 		auto thread_count = max_threads_ > 0 ? max_threads_ : std::thread::hardware_concurrency() + max_threads_;
+		metrics_.set_workers( thread_count );
+		vector< evaluator_metrics::task > tasks;
+		tasks.reserve( point_vec.size() );
+		for ( index_t i = 0; i < point_vec.size(); ++i )
+			tasks.push_back( metrics_.queue_task() );
 		for ( index_t eval_idx = 0; eval_idx < point_vec.size(); ++eval_idx )
 		{
-			// wait for threads to finish
-			while ( threads.size() >= thread_count )
+			// wait for threads to finish, unless the remaining evaluations are cancelled
+			while ( threads.size() >= thread_count && !st.stop_requested() )
 			{
 				for ( auto it = threads.begin(); it != threads.end(); )
 				{
@@ -51,8 +69,17 @@ namespace spot
 				}
 			}
 
+			// evaluations that have not started are cancelled after a stop request
+			if ( st.stop_requested() )
+			{
+				metrics_.cancel_task( tasks[eval_idx] );
+				results[eval_idx] = xo::error_message( evaluation_cancelled_message );
+				durations[eval_idx] = 0;
+				continue;
+			}
+
 			// add new thread
-			threads.push_back( std::make_pair( evaluate_async( o, point_vec[eval_idx], st ), eval_idx ) );
+			threads.push_back( std::make_pair( evaluate_async( o, point_vec[eval_idx], st, tasks[eval_idx], &durations[eval_idx] ), eval_idx ) );
 		}
 
 		// wait for remaining threads
@@ -18,7 +18,7 @@ namespace spot
 		void set_max_threads( int max_threads, xo::thread_priority prio );
 
 	protected:
-		std::future< xo::result< fitness_t > > evaluate_async( const objective& o, const search_point& point, const xo::stop_token& st ) const;
+		std::future< xo::result< fitness_t > > evaluate_async( const objective& o, const search_point& point, const xo::stop_token& st, evaluator_metrics::task task, double* duration );
 		void set_result( xo::result< fitness_t > result, fitness_t* value, xo::error_message* error ) const;
 
 		int max_threads_;
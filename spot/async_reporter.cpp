@@ -0,0 +1,302 @@
+#include "async_reporter.h"
+
+#include "optimizer.h"
+#include "evaluator.h"
+#include "xo/system/log.h"
+
+namespace spot
+{
+	// parts of the optimizer state that are copied for an event, in addition to counts and best fitness
+	enum capture_flags { capture_current_step = 1, capture_history = 2, capture_info = 4 };
+
+	// copy of the optimizer state that reporters can access, it cannot be stepped
+	class optimizer_snapshot : public optimizer
+	{
+	public:
+		optimizer_snapshot( const optimizer& o ) :
+			optimizer( o.obj(), snapshot_evaluator() ),
+			state_labels_( o.optimizer_state_labels() )
+		{}
+
+		// copy assignment of vectors and search points reuses the storage of the snapshot
+		// state that is not captured is cleared, so that reporters never see state of an earlier event
+		void assign( const optimizer& o, int capture, std::shared_ptr< const objective_info > info )
+		{
+			name = o.name;
+			step_count_ = o.current_step();
+			evaluation_count_ = o.evaluation_count();
+			best_fitness_ = o.best_fitness();
+			best_point_.set_values( o.best_point().values() );
+			current_step_best_fitness_ = o.current_step_best_fitness();
+			current_step_best_point_.set_values( o.current_step_best_point().values() );
+
+			if ( capture & capture_current_step )
+			{
+				current_step_fitnesses_ = o.current_step_fitnesses();
+				current_step_evaluation_durations_ = o.current_step_evaluation_durations();
+			}
+			else
+			{
+				current_step_fitnesses_.clear();
+				current_step_evaluation_durations_.clear();
+			}
+
+			// only the history is copied, the trend is computed on the reporter thread when it is used
+			if ( fitness_history_.capacity() != o.fitness_history_.capacity() )
+				fitness_history_.reserve( o.fitness_history_.capacity() );
+			fitness_history_.clear();
+			fitness_history_samples_ = 0;
+			fitness_trend_step_ = no_index;
+			if ( capture & capture_history )
+			{
+				for ( auto f : o.fitness_history_ )
+					fitness_history_.push_back( f );
+				fitness_history_samples_ = o.fitness_history_samples_;
+				if ( o.fitness_trend_estimator_ == trend_estimator::incremental )
+				{
+					// the incremental tracker is not copied, its trend is cheap to get
+					fitness_trend_ = o.fitness_trend();
+					fitness_trend_step_ = fitness_history_samples_;
+				}
+				state_values_ = o.optimizer_state_values();
+			}
+			else state_values_.clear();
+
+			updated_info_ = capture & capture_info ? std::move( info ) : nullptr;
+		}
+
+		virtual objective_info make_updated_objective_info() const override {
+			xo_error_if( !updated_info_, "Updated objective info is not available for this event" );
+			return *updated_info_;
+		}
+		virtual vector< string > optimizer_state_labels() const override { return state_labels_; }
+		virtual vector< par_t > optimizer_state_values() const override { return state_values_; }
+
+	protected:
+		virtual bool internal_step() override { xo_error( "Cannot step an optimizer snapshot" ); }
+
+	private:
+		static evaluator& snapshot_evaluator() { static sequential_evaluator eval; return eval; }
+
+		std::shared_ptr< const objective_info > updated_info_;
+		vector< string > state_labels_;
+		vector< par_t > state_values_;
+	};
+
+	enum class async_reporter::event_type { post_evaluate_point, pre_evaluate_population, post_evaluate_population, new_best, pre_step, post_step };
+
+	struct async_reporter::event
+	{
+		event( const optimizer& o ) : snapshot( o ), point( o.info() ) {}
+
+		event_type type = event_type::pre_step;
+		optimizer_snapshot snapshot;
+		search_point_vec population;
+		fitness_vec fitnesses;
+		search_point point;
+		fitness_t fitness = 0;
+		bool new_best = false;
+	};
+
+	async_reporter::async_reporter( size_t queue_size, async_overflow_policy policy ) :
+		queue_size_( std::max<size_t>( 1, queue_size ) ),
+		policy_( policy ),
+		head_( 0 ),
+		count_( 0 ),
+		dropped_( 0 ),
+		stop_( false ),
+		info_optimizer_( nullptr ),
+		info_step_( 0 ),
+		info_evaluation_count_( 0 )
+	{
+		thread_ = std::thread( &async_reporter::thread_func, this );
+	}
+
+	async_reporter::~async_reporter()
+	{
+		// remaining events are processed before the thread ends
+		{
+			std::scoped_lock lock( mutex_ );
+			stop_ = true;
+		}
+		queue_cv_.notify_one();
+		thread_.join();
+	}
+
+	reporter& async_reporter::add_reporter( u_ptr<reporter> rep )
+	{
+		flush();
+		std::scoped_lock lock( mutex_ );
+		return *reporters_.emplace_back( std::move( rep ) );
+	}
+
+	void async_reporter::on_start( const optimizer& opt )
+	{
+		flush();
+		for ( auto& r : reporters_ )
+			r->on_start( opt );
+	}
+
+	void async_reporter::on_stop( const optimizer& opt, const stop_condition& s )
+	{
+		flush();
+		for ( auto& r : reporters_ )
+			r->on_stop( opt, s );
+	}
+
+	void async_reporter::on_post_evaluate_point( const optimizer& opt, const search_point& point, fitness_t fitness )
+	{
+		if ( auto* e = begin_event( opt, event_type::post_evaluate_point, 0 ) )
+		{
+			e->point = point;
+			e->fitness = fitness;
+			end_event();
+		}
+	}
+
+	void async_reporter::on_pre_evaluate_population( const optimizer& opt, const search_point_vec& pop )
+	{
+		if ( auto* e = begin_event( opt, event_type::pre_evaluate_population, 0 ) )
+		{
+			e->population = pop;
+			end_event();
+		}
+	}
+
+	void async_reporter::on_post_evaluate_population( const optimizer& opt, const search_point_vec& pop, const fitness_vec& fitnesses, bool new_best )
+	{
+		if ( auto* e = begin_event( opt, event_type::post_evaluate_population, capture_current_step | capture_info ) )
+		{
+			e->population = pop;
+			e->fitnesses = fitnesses;
+			e->new_best = new_best;
+			end_event();
+		}
+	}
+
+	void async_reporter::on_new_best( const optimizer& opt, const search_point& point, fitness_t fitness )
+	{
+		if ( auto* e = begin_event( opt, event_type::new_best, capture_current_step | capture_info ) )
+		{
+			e->point = point;
+			e->fitness = fitness;
+			end_event();
+		}
+	}
+
+	void async_reporter::on_pre_step( const optimizer& opt )
+	{
+		if ( begin_event( opt, event_type::pre_step, 0 ) )
+			end_event();
+	}
+
+	void async_reporter::on_post_step( const optimizer& opt )
+	{
+		if ( begin_event( opt, event_type::post_step, capture_current_step | capture_history ) )
+			end_event();
+	}
+
+	void async_reporter::flush()
+	{
+		std::unique_lock lock( mutex_ );
+		done_cv_.wait( lock, [&]() { return count_ == 0; } );
+	}
+
+	size_t async_reporter::dropped_events() const
+	{
+		std::scoped_lock lock( mutex_ );
+		return dropped_;
+	}
+
+	async_reporter::event* async_reporter::begin_event( const optimizer& opt, event_type type, int capture )
+	{
+		std::unique_lock lock( mutex_ );
+		if ( events_.empty() )
+		{
+			// allocate all snapshots up front, they are reused for each event
+			for ( index_t i = 0; i < queue_size_; ++i )
+				events_.emplace_back( std::make_unique< event >( opt ) );
+		}
+
+		if ( count_ == events_.size() )
+		{
+			if ( policy_ == async_overflow_policy::drop )
+			{
+				++dropped_;
+				return nullptr;
+			}
+			else done_cv_.wait( lock, [&]() { return count_ < events_.size(); } );
+		}
+
+		// the slot after the last queued event is not accessed by the reporter thread
+		auto* e = events_[( head_ + count_ ) % events_.size()].get();
+		lock.unlock();
+
+		e->type = type;
+		e->snapshot.assign( opt, capture, capture & capture_info ? updated_info( opt ) : nullptr );
+		return e;
+	}
+
+	std::shared_ptr< const objective_info > async_reporter::updated_info( const optimizer& opt )
+	{
+		// events of the same step share the updated info, it is created at most once per step
+		if ( &opt != info_optimizer_ || opt.current_step() != info_step_ || opt.evaluation_count() != info_evaluation_count_ )
+		{
+			info_optimizer_ = &opt;
+			info_step_ = opt.current_step();
+			info_evaluation_count_ = opt.evaluation_count();
+			try { info_ = std::make_shared< const objective_info >( opt.make_updated_objective_info() ); }
+			catch ( std::exception& ) { info_.reset(); } // not all optimizers support this
+		}
+		return info_;
+	}
+
+	void async_reporter::end_event()
+	{
+		{
+			std::scoped_lock lock( mutex_ );
+			++count_;
+		}
+		queue_cv_.notify_one();
+	}
+
+	void async_reporter::thread_func()
+	{
+		std::unique_lock lock( mutex_ );
+		while ( true )
+		{
+			queue_cv_.wait( lock, [&]() { return count_ > 0 || stop_; } );
+			if ( count_ == 0 )
+				break; // stopped and all events are processed
+
+			auto& e = *events_[head_];
+			lock.unlock();
+
+			for ( auto& r : reporters_ )
+			{
+				try
+				{
+					auto& opt = e.snapshot;
+					switch ( e.type )
+					{
+					case event_type::post_evaluate_point: r->on_post_evaluate_point( opt, e.point, e.fitness ); break;
+					case event_type::pre_evaluate_population: r->on_pre_evaluate_population( opt, e.population ); break;
+					case event_type::post_evaluate_population: r->on_post_evaluate_population( opt, e.population, e.fitnesses, e.new_best ); break;
+					case event_type::new_best: r->on_new_best( opt, e.point, e.fitness ); break;
+					case event_type::pre_step: r->on_pre_step( opt ); break;
+					case event_type::post_step: r->on_post_step( opt ); break;
+					}
+				}
+				catch ( std::exception& ex )
+				{
+					xo::log::error( "Error in reporter: ", ex.what() );
+				}
+			}
+
+			lock.lock();
+			head_ = ( head_ + 1 ) % events_.size();
+			--count_;
+			done_cv_.notify_all();
+		}
+	}
+}
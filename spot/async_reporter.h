@@ -0,0 +1,74 @@
+#pragma once
+
+#include "reporter.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace spot
+{
+	/// What to do with new events when the queue of an async_reporter is full.
+	enum class async_overflow_policy { block, drop };
+
+	/// Forwards reporter callbacks to wrapped reporters on a background thread.
+	/// For each event, the optimizer state needed for that event is copied into a ring buffer of preallocated snapshots,
+	/// wrapped reporters receive a snapshot instead of the actual optimizer. All events include counts and best points,
+	/// on_post_evaluate_population, on_new_best and on_post_step include the fitnesses of the current step,
+	/// on_post_step includes the fitness history and optimizer state values,
+	/// on_post_evaluate_population and on_new_best include the updated objective info (created once per step).
+	/// The fitness trend is computed on the background thread when a reporter uses it.
+	/// on_start and on_stop are forwarded directly, after all queued events are processed.
+	/// Callbacks must come from a single thread, which is the case for any optimizer.
+	class SPOT_API async_reporter : public reporter
+	{
+	public:
+		async_reporter( size_t queue_size = 16, async_overflow_policy policy = async_overflow_policy::block );
+		virtual ~async_reporter();
+
+		reporter& add_reporter( u_ptr<reporter> rep );
+
+		virtual void on_start( const optimizer& opt ) override;
+		virtual void on_stop( const optimizer& opt, const stop_condition& s ) override;
+		virtual void on_post_evaluate_point( const optimizer& opt, const search_point& point, fitness_t fitness ) override;
+		virtual void on_pre_evaluate_population( const optimizer& opt, const search_point_vec& pop ) override;
+		virtual void on_post_evaluate_population( const optimizer& opt, const search_point_vec& pop, const fitness_vec& fitnesses, bool new_best ) override;
+		virtual void on_new_best( const optimizer& opt, const search_point& point, fitness_t fitness ) override;
+		virtual void on_pre_step( const optimizer& opt ) override;
+		virtual void on_post_step( const optimizer& opt ) override;
+
+		/// Wait until all queued events have been processed.
+		void flush();
+
+		/// Number of events discarded because the queue was full.
+		size_t dropped_events() const;
+
+	private:
+		struct event;
+		enum class event_type;
+
+		event* begin_event( const optimizer& opt, event_type type, int capture );
+		std::shared_ptr< const objective_info > updated_info( const optimizer& opt );
+		void end_event();
+		void thread_func();
+
+		size_t queue_size_;
+		async_overflow_policy policy_;
+		vector< u_ptr< reporter > > reporters_;
+
+		vector< u_ptr< event > > events_;
+		size_t head_;
+		size_t count_;
+		size_t dropped_;
+		bool stop_;
+		mutable std::mutex mutex_;
+		std::condition_variable queue_cv_;
+		std::condition_variable done_cv_;
+		std::thread thread_;
+
+		// updated objective info of the most recent step, only accessed by the optimizer thread
+		std::shared_ptr< const objective_info > info_;
+		const optimizer* info_optimizer_;
+		size_t info_step_;
+		size_t info_evaluation_count_;
+	};
+}
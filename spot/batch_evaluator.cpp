@@ -1,6 +1,7 @@
 #include "batch_evaluator.h"
 
 #include "objective.h"
+#include "tracer.h"
 
 namespace spot
 {
@@ -13,12 +14,25 @@ namespace spot
 	{
 		// create threads
 		vector< std::future< xo::result< fitness_t > > > futures;
-		for ( const auto& point : point_vec )
+		auto& durations = thread_evaluation_durations();
+		durations.resize( point_vec.size() );
+		metrics_.set_workers( point_vec.size() );
+		for ( index_t i = 0; i < point_vec.size(); ++i )
 		{
 			futures.emplace_back(
-				std::async( std::launch::async, [&]() {
+				std::async( std::launch::async, [&, i, task = metrics_.queue_task()]() mutable -> xo::result< fitness_t > {
+					if ( st.stop_requested() )
+					{
+						metrics_.cancel_task( task );
+						durations[i] = 0;
+						return xo::error_message( evaluation_cancelled_message );
+					}
 					xo::set_thread_priority( thread_prio_ );
-					return o.evaluate_noexcept( point, st );
+					SPOT_TRACE_SCOPE( "evaluator::evaluate" );
+					metrics_.start_task( task );
+					auto result = o.evaluate_noexcept( point_vec[i], st );
+					durations[i] = metrics_.finish_task( task, !result );
+					return result;
 					} )
 			);
 		}
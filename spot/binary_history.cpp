@@ -0,0 +1,115 @@
+#include "binary_history.h"
+#include "binary_io.h"
+
+#include "xo/system/assert.h"
+#include <cstdint>
+#include <cstring>
+
+namespace spot
+{
+	// header layout: magic, version, column count, labels (length + chars), padding to 8 bytes
+	static const char binary_history_magic[8] = { 'S', 'P', 'O', 'T', 'H', 'I', 'S', 'T' };
+	static const uint32_t binary_history_version = 1;
+
+	void binary_history_writer::open( const path& filename, const vector< string >& labels )
+	{
+		str_ = std::ofstream( filename.str(), std::ios::binary );
+		xo_error_if( !str_.good(), "Could not open " + filename.str() );
+		columns_ = labels.size();
+
+		str_.write( binary_history_magic, sizeof( binary_history_magic ) );
+		write_binary( str_, binary_history_version );
+		write_binary( str_, uint32_t( columns_ ) );
+		for ( auto& l : labels )
+		{
+			write_binary( str_, uint32_t( l.size() ) );
+			str_.write( l.data(), l.size() );
+		}
+
+		// align rows to 8 bytes
+		while ( str_.tellp() % sizeof( double ) != 0 )
+			str_.put( 0 );
+	}
+
+	void binary_history_writer::write_row( const vector< double >& values )
+	{
+		xo_error_if( values.size() != columns_, "Number of values does not match the number of columns" );
+		str_.write( reinterpret_cast<const char*>( values.data() ), values.size() * sizeof( double ) );
+	}
+
+	binary_history_reader::binary_history_reader( const path& filename ) :
+		str_( filename.str(), std::ios::binary ),
+		data_offset_( 0 ),
+		rows_( 0 )
+	{
+		xo_error_if( !str_.good(), "Could not open " + filename.str() );
+
+		char magic[sizeof( binary_history_magic )];
+		str_.read( magic, sizeof( magic ) );
+		xo_error_if( !str_ || std::memcmp( magic, binary_history_magic, sizeof( magic ) ) != 0, filename.str() + " is not a binary history file" );
+		auto version = read_binary< uint32_t >( str_ );
+		xo_error_if( version != binary_history_version, "Unsupported binary history version in " + filename.str() );
+
+		auto columns = read_binary< uint32_t >( str_ );
+		for ( uint32_t i = 0; i < columns && str_; ++i )
+		{
+			auto& l = labels_.emplace_back( read_binary< uint32_t >( str_ ), '\0' );
+			str_.read( l.data(), l.size() );
+		}
+		xo_error_if( !str_, "Could not read header of " + filename.str() );
+
+		data_offset_ = str_.tellg();
+		data_offset_ += ( sizeof( double ) - data_offset_ % sizeof( double ) ) % sizeof( double );
+		str_.seekg( 0, std::ios::end );
+		if ( columns > 0 )
+			rows_ = size_t( str_.tellg() - data_offset_ ) / ( columns * sizeof( double ) );
+	}
+
+	index_t binary_history_reader::find_column( const string& label ) const
+	{
+		for ( index_t i = 0; i < labels_.size(); ++i )
+			if ( labels_[i] == label )
+				return i;
+		return no_index;
+	}
+
+	vector< double > binary_history_reader::column( index_t col ) const
+	{
+		xo_error_if( col >= columns(), "Invalid column index" );
+		vector< double > result( rows_ );
+
+		// read blocks of rows and pick the column values
+		const size_t block_rows = std::max<size_t>( 1, 8192 / columns() );
+		vector< double > block( block_rows * columns() );
+		str_.clear();
+		str_.seekg( data_offset_ );
+		for ( index_t r = 0; r < rows_; r += block_rows )
+		{
+			auto n = std::min( block_rows, rows_ - r );
+			str_.read( reinterpret_cast<char*>( block.data() ), n * columns() * sizeof( double ) );
+			for ( index_t i = 0; i < n; ++i )
+				result[r + i] = block[i * columns() + col];
+		}
+		xo_error_if( !str_, "Error reading binary history" );
+
+		return result;
+	}
+
+	vector< double > binary_history_reader::column( const string& label ) const
+	{
+		auto col = find_column( label );
+		xo_error_if( col == no_index, "Could not find column " + label );
+		return column( col );
+	}
+
+	vector< double > binary_history_reader::row( index_t row ) const
+	{
+		xo_error_if( row >= rows_, "Invalid row index" );
+		vector< double > result( columns() );
+		str_.clear();
+		str_.seekg( data_offset_ + std::streamoff( row * columns() * sizeof( double ) ) );
+		str_.read( reinterpret_cast<char*>( result.data() ), columns() * sizeof( double ) );
+		xo_error_if( !str_, "Error reading binary history" );
+		return result;
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "spot_types.h"
+#include <fstream>
+
+namespace spot
+{
+	/// Append-only binary history file.
+	/// The header contains the column labels, followed by fixed-width rows of float64 values.
+	/// Values are stored in native byte order; an incomplete last row is ignored when reading.
+	class SPOT_API binary_history_writer
+	{
+	public:
+		binary_history_writer() : columns_( 0 ) {}
+		binary_history_writer( const path& filename, const vector< string >& labels ) { open( filename, labels ); }
+
+		void open( const path& filename, const vector< string >& labels );
+		bool is_open() const { return str_.is_open(); }
+		size_t columns() const { return columns_; }
+
+		/// Write a row, the number of values must match the number of columns.
+		void write_row( const vector< double >& values );
+		void flush() { str_.flush(); }
+
+	private:
+		std::ofstream str_;
+		size_t columns_;
+	};
+
+	/// Reads single columns or rows from a binary history file without parsing the whole file.
+	class SPOT_API binary_history_reader
+	{
+	public:
+		binary_history_reader( const path& filename );
+
+		const vector< string >& labels() const { return labels_; }
+		size_t columns() const { return labels_.size(); }
+		size_t rows() const { return rows_; }
+
+		/// Index of column with label, or no_index if not found.
+		index_t find_column( const string& label ) const;
+		vector< double > column( index_t col ) const;
+		vector< double > column( const string& label ) const;
+		vector< double > row( index_t row ) const;
+
+	private:
+		mutable std::ifstream str_;
+		vector< string > labels_;
+		std::streamoff data_offset_;
+		size_t rows_;
+	};
+}
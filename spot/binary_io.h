@@ -0,0 +1,18 @@
+#pragma once
+
+#include <iostream>
+
+namespace spot
+{
+	/// Write a value in native byte order.
+	template< typename T > void write_binary( std::ostream& str, const T& v ) {
+		str.write( reinterpret_cast<const char*>( &v ), sizeof( T ) );
+	}
+
+	/// Read a value in native byte order.
+	template< typename T > T read_binary( std::istream& str ) {
+		T v{};
+		str.read( reinterpret_cast<char*>( &v ), sizeof( T ) );
+		return v;
+	}
+}
@@ -1,4 +1,8 @@
 #include "boundary_transformer.h"
+#include "cma_kernels.h"
+#include "simd_dispatch.h"
+
+#include <algorithm>
 
 #include "xo/system/assert.h"
 #include "xo/system/log.h"
@@ -7,100 +11,151 @@
 
 namespace spot
 {
+	void boundary_transformer::apply_batch( par_t* points, size_t count )
+	{
+		par_vec v( info_.dim() );
+		for ( size_t k = 0; k < count; ++k, points += v.size() ) {
+			std::copy_n( points, v.size(), v.begin() );
+			apply( v );
+			std::copy( v.begin(), v.end(), points );
+		}
+	}
+
+	void boundary_transformer::apply_inverse_batch( par_t* points, size_t count )
+	{
+		par_vec v( info_.dim() );
+		for ( size_t k = 0; k < count; ++k, points += v.size() ) {
+			std::copy_n( points, v.size(), v.begin() );
+			apply_inverse( v );
+			std::copy( v.begin(), v.end(), points );
+		}
+	}
 
 	soft_limit_boundary_transformer::soft_limit_boundary_transformer( const objective_info& i, par_t threshold ) :
 		boundary_transformer( i ),
-		boundary_limit_threshold_( threshold )
+		boundary_limit_threshold_( threshold ),
+		lb_( i.lower_bounds() ),
+		ub_( i.upper_bounds() )
+	{}
+
+	void soft_limit_boundary_transformer::apply( par_vec& v )
 	{
+		xo_assert( v.size() == info_.dim() );
+		apply_batch( v.data(), 1 );
 	}
 
-	void soft_limit_boundary_transformer::apply( par_vec& v )
+	void soft_limit_boundary_transformer::apply_inverse( par_vec& v )
 	{
 		xo_assert( v.size() == info_.dim() );
-		for ( index_t i = 0; i < v.size(); ++i )
-			xo::soft_clamp( v[i], info_[i].min, info_[i].max, boundary_limit_threshold_ );
+		apply_inverse_batch( v.data(), 1 );
 	}
 
+	void soft_limit_boundary_transformer::apply_batch( par_t* points, size_t count )
+	{
+		// soft_clamp has no vectorized form, but the bounds are read from contiguous arrays
+		const auto n = lb_.size();
+		for ( size_t k = 0; k < count; ++k, points += n )
+			for ( index_t i = 0; i < n; ++i )
+				xo::soft_clamp( points[i], lb_[i], ub_[i], boundary_limit_threshold_ );
+	}
+
+	void soft_limit_boundary_transformer::apply_inverse_batch( par_t* points, size_t count )
+	{
+		// soft_clamp is monotonic, the preimage is found through bisection
+		const auto n = lb_.size();
+		for ( size_t k = 0; k < count; ++k, points += n ) {
+			for ( index_t i = 0; i < n; ++i ) {
+				auto f = [&]( par_t x ) { return xo::soft_clamp( x, lb_[i], ub_[i], boundary_limit_threshold_ ); };
+				const par_t y = points[i];
+				if ( f( y ) == y )
+					continue; // most points are within the identity region
+				auto range = ub_[i] - lb_[i];
+				par_t lo = lb_[i] - range, hi = ub_[i] + range;
+				for ( int it = 0; it < 64 && f( lo ) > y; ++it, range *= 2 )
+					lo -= range;
+				for ( int it = 0; it < 64 && f( hi ) < y; ++it, range *= 2 )
+					hi += range;
+				for ( int it = 0; it < 100 && lo < hi; ++it ) {
+					auto mid = lo + ( hi - lo ) / 2;
+					if ( mid == lo || mid == hi )
+						break;
+					if ( f( mid ) < y )
+						lo = mid;
+					else hi = mid;
+				}
+				points[i] = lo + ( hi - lo ) / 2;
+			}
+		}
+	}
+
+	reflective_boundary_transformer::reflective_boundary_transformer( const objective_info& i ) :
+		boundary_transformer( i ),
+		lb_( i.lower_bounds() ),
+		ub_( i.upper_bounds() )
+	{}
+
 	void reflective_boundary_transformer::apply( par_vec& v )
 	{
 		xo_assert( v.size() == info_.dim() );
-		for ( index_t i = 0; i < v.size(); ++i ) {
-			auto l = info_[i].min, u = info_[i].max;
-			if ( v[i] < l || v[i] > u )
-				v[i] = xo::triangle_wave( v[i], l, u );
-		}
+		apply_batch( v.data(), 1 );
+	}
+
+	void reflective_boundary_transformer::apply_inverse( par_vec& v )
+	{
+		xo_assert( v.size() == info_.dim() );
+		apply_inverse_batch( v.data(), 1 );
+	}
+
+	void reflective_boundary_transformer::apply_batch( par_t* points, size_t count )
+	{
+		simd().reflective_transform( lb_.size(), count, points, lb_.data(), ub_.data() );
+	}
+
+	void reflective_boundary_transformer::apply_inverse_batch( par_t* points, size_t count )
+	{
+		// the reflection is the identity within bounds, so feasible points are their own preimage
+		simd().reflective_transform( lb_.size(), count, points, lb_.data(), ub_.data() );
 	}
 
 	cmaes_boundary_transformer::cmaes_boundary_transformer( const objective_info& info ) :
-		boundary_transformer( info )
+		boundary_transformer( info ),
+		lb_( info.lower_bounds() ),
+		ub_( info.upper_bounds() )
 	{
 		auto len = info_.dim();
-		lb_.resize( len );
-		ub_.resize( len );
 		al_.resize( len );
 		au_.resize( len );
 
 		for ( index_t i = 0; i < len; ++i )
 		{
-			lb_[i] = info_[i].min;
-			ub_[i] = info_[i].max;
-
 			if ( lb_[i] == ub_[i] || ub_[i] < lb_[i] )
 				xo_error( "Invalid upper and lower bounds for parameter " + info[i].name );
 
 			/* between lb+al and ub-au transformation is the identity */
-			al_[i] = fmin( ( ub_[i] - lb_[i] ) / 2., ( 1. + fabs( lb_[i] ) ) / 20. );
-			au_[i] = fmin( ( ub_[i] - lb_[i] ) / 2., ( 1. + fabs( ub_[i] ) ) / 20. );
+			al_[i] = cmaes_boundary_margin( lb_[i], ub_[i], lb_[i] );
+			au_[i] = cmaes_boundary_margin( lb_[i], ub_[i], ub_[i] );
 		}
 	}
 
 	void cmaes_boundary_transformer::apply( par_vec& x )
 	{
-		auto len = lb_.size();
-
-		// cmaes_boundary_trans_shift_into_feasible_preimage
-		for ( size_t i = 0; i < len; ++i ) {
-			double lb, ub, al, au, r, xlow, xup;
-			lb = lb_[i];
-			ub = ub_[i];
-			al = al_[i];
-			au = au_[i];
-			xlow = lb - 2 * al - ( ub - lb ) / 2.0;
-			xup = ub + 2 * au + ( ub - lb ) / 2.0;
-			r = 2 * ( ub - lb + al + au ); /* == xup - xlow == period of the transformation */
-
-			auto y = x[i];
-
-			if ( y < xlow ) { /* shift up */
-				y += r * ( 1 + (int)( ( xlow - y ) / r ) );
-			}
-			if ( y > xup ) { /* shift down */
-				y -= r * ( 1 + (int)( ( y - xup ) / r ) );
-				/* printf(" \n%f\n", fmod(y[i] - ub - au, r)); */
-			}
-			if ( y < lb - al ) /* mirror */
-				y += 2 * ( lb - al - y );
-			if ( y > ub + au )
-				y -= 2 * ( y - ub - au );
+		xo_assert( x.size() == lb_.size() );
+		apply_batch( x.data(), 1 );
+	}
 
-			if ( ( y < lb - al - 1e-15 ) || ( y > ub + au + 1e-15 ) ) {
-				xo::log::error( xo::stringf( "BUG in cmaes_boundary_transformation_shift_into_feasible_preimage: lb=%f, ub=%f, al=%f au=%f, x=%f, y=%f, i=%d\n", lb, ub, al, au, x[i], y, i ) );
-			}
-			else x[i] = y;
-		}
+	void cmaes_boundary_transformer::apply_inverse( par_vec& x )
+	{
+		xo_assert( x.size() == lb_.size() );
+		apply_inverse_batch( x.data(), 1 );
+	}
 
-		for ( size_t i = 0; i < len; ++i ) {
-			double lb, ub, al, au;
-			lb = lb_[i];
-			ub = ub_[i];
-			al = al_[i];
-			au = au_[i];
-			auto y = x[i];
-			if ( y < lb + al )
-				y = lb + ( y - ( lb - al ) ) * ( y - ( lb - al ) ) / 4. / al;
-			else if ( y > ub - au )
-				y = ub - ( y - ( ub + au ) ) * ( y - ( ub + au ) ) / 4. / au;
-			x[i] = y;
-		}
+	void cmaes_boundary_transformer::apply_batch( par_t* points, size_t count )
+	{
+		simd().boundary_transform( lb_.size(), count, points, lb_.data(), ub_.data(), al_.data(), au_.data() );
+	}
+
+	void cmaes_boundary_transformer::apply_inverse_batch( par_t* points, size_t count )
+	{
+		simd().boundary_transform_inverse( lb_.size(), count, points, lb_.data(), ub_.data(), al_.data(), au_.data() );
 	}
 }
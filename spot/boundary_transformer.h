@@ -11,6 +11,12 @@ namespace spot
 		virtual ~boundary_transformer() {}
 		virtual void apply( par_vec& v ) = 0;
 		virtual void apply_inverse( par_vec& v ) { XO_NOT_IMPLEMENTED; };
+		virtual bool has_inverse() const { return false; }
+
+		/// transform count points of dim() parameters, stored contiguously row by row
+		/// the default implementations call apply() or apply_inverse() for each point
+		virtual void apply_batch( par_t* points, size_t count );
+		virtual void apply_inverse_batch( par_t* points, size_t count );
 
 	protected:
 		const objective_info& info_;
@@ -21,15 +27,28 @@ namespace spot
 	public:
 		soft_limit_boundary_transformer( const objective_info& i, par_t threshold = 0.1 );
 		virtual void apply( par_vec& v ) override;
+		virtual void apply_inverse( par_vec& v ) override;
+		virtual bool has_inverse() const override { return true; }
+		virtual void apply_batch( par_t* points, size_t count ) override;
+		virtual void apply_inverse_batch( par_t* points, size_t count ) override;
 	private:
 		par_t boundary_limit_threshold_;
+		par_vec lb_;
+		par_vec ub_;
 	};
 
 	class SPOT_API reflective_boundary_transformer : public boundary_transformer
 	{
 	public:
-		reflective_boundary_transformer( const objective_info& i ) : boundary_transformer( i ) {}
+		reflective_boundary_transformer( const objective_info& i );
 		virtual void apply( par_vec& v ) override;
+		virtual void apply_inverse( par_vec& v ) override;
+		virtual bool has_inverse() const override { return true; }
+		virtual void apply_batch( par_t* points, size_t count ) override;
+		virtual void apply_inverse_batch( par_t* points, size_t count ) override;
+	private:
+		par_vec lb_;
+		par_vec ub_;
 	};
 
 	class SPOT_API cmaes_boundary_transformer : public boundary_transformer
@@ -37,6 +56,10 @@ namespace spot
 	public:
 		cmaes_boundary_transformer( const objective_info& i );
 		virtual void apply( par_vec& v ) override;
+		virtual void apply_inverse( par_vec& v ) override;
+		virtual bool has_inverse() const override { return true; }
+		virtual void apply_batch( par_t* points, size_t count ) override;
+		virtual void apply_inverse_batch( par_t* points, size_t count ) override;
 	private:
 		par_vec lb_; /* array of size len_of_bounds */
 		par_vec ub_; /* array of size len_of_bounds */
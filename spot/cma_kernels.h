@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+namespace spot
+{
+	// Inner loops of cma_optimizer, templated on scalar type so that they can be run in single precision.
+	// Matrices are accessed as m[row][col], which works for nested vectors as well as row pointers.
+	// VectorBytes is the register width the loops are blocked for, see simd_dispatch.h.
+
+	/// Dot product with independent partial sums, which allows the compiler to vectorize it.
+	template< typename T, size_t VectorBytes = 32 >
+	T cma_dot( size_t n, const T* a, const T* b ) {
+		constexpr size_t lanes = VectorBytes / sizeof( T );
+		T acc[lanes] = {};
+		size_t j = 0;
+		for ( ; j + lanes <= n; j += lanes )
+			for ( size_t l = 0; l < lanes; ++l )
+				acc[l] += a[j + l] * b[j + l];
+
+		// remainder with a local trip count, which avoids -Waggressive-loop-optimizations when n is known after inlining
+		const size_t tail = n - j;
+		a += j;
+		b += j;
+		T sum = 0;
+		for ( size_t t = 0; t < tail; ++t )
+			sum += a[t] * b[t];
+		for ( auto v : acc )
+			sum += v;
+		return sum;
+	}
+
+	/// Compute y = B * ( d .* z ), which maps a standard normal sample z to N(0,C).
+	template< typename T, typename MatrixT, size_t VectorBytes = 32 >
+	void cma_transform_sample( size_t n, const MatrixT& B, const T* d, const T* z, T* dz, T* y ) {
+		for ( size_t j = 0; j < n; ++j )
+			dz[j] = d[j] * z[j];
+		for ( size_t i = 0; i < n; ++i )
+			y[i] = cma_dot< T, VectorBytes >( n, &B[i][0], dz );
+	}
+
+	/// Rank-one and rank-mu update of the lower triangle of C (C[i][j] with j <= i):
+	/// C = c_old * C + c1 * pc * pc^T + cmu * sum_k w_k * y_k * y_k^T, with y_k = ( x_k - old_mean ) / sigma.
+	/// If diagonal is set, only the diagonal of C is updated.
+	template< typename T, typename MatrixT, typename StepsT, size_t VectorBytes = 32 >
+	void cma_update_covariance( size_t n, MatrixT& C, T c_old, T c1, T cmu, const T* pc, size_t mu, const T* weights, const StepsT& y, bool diagonal ) {
+		constexpr size_t lanes = VectorBytes / sizeof( T );
+		for ( size_t i = 0; i < n; ++i )
+		{
+			auto* row = &C[i][0];
+			const T c1_pci = c1 * pc[i];
+			size_t j = diagonal ? i : 0;
+
+			// blocks of each row are kept in registers while adding all samples, which allows vectorization
+			for ( ; j + lanes <= i + 1; j += lanes )
+			{
+				T acc[lanes];
+				for ( size_t l = 0; l < lanes; ++l )
+					acc[l] = c_old * row[j + l] + c1_pci * pc[j + l];
+				for ( size_t k = 0; k < mu; ++k )
+				{
+					const auto* yk = &y[k][0];
+					const T f = cmu * weights[k] * yk[i];
+					for ( size_t l = 0; l < lanes; ++l )
+						acc[l] += f * yk[j + l];
+				}
+				for ( size_t l = 0; l < lanes; ++l )
+					row[j + l] = acc[l];
+			}
+			for ( ; j <= i; ++j )
+			{
+				T v = c_old * row[j] + c1_pci * pc[j];
+				for ( size_t k = 0; k < mu; ++k )
+					v += cmu * weights[k] * y[k][i] * y[k][j];
+				row[j] = v;
+			}
+		}
+	}
+
+	/// Width of the quadratic region of the cmaes boundary transformation at bound.
+	template< typename T >
+	T cmaes_boundary_margin( T lower, T upper, T bound ) {
+		return std::min( ( upper - lower ) / T( 2 ), ( T( 1 ) + std::abs( bound ) ) / T( 20 ) );
+	}
+
+	/// Boundary transformation of cmaes: maps any x into [lb, ub], is the identity between lb + al and ub - au,
+	/// quadratic near the bounds, and periodic outside. Written with min / max instead of branches, so that it vectorizes.
+	/// With an infinite bound, the margin at that bound is infinite and the transformation is not periodic.
+	template< typename T >
+	T cmaes_boundary_transform( T x, T lb, T ub, T al, T au ) {
+		// shift into feasible pre-image [xlow, xlow + r], r is the period of the transformation
+		const T xlow = lb - 2 * al - ( ub - lb ) / T( 2 );
+		const T r = 2 * ( ub - lb + al + au );
+		x -= r < std::numeric_limits< T >::infinity() ? r * std::floor( ( x - xlow ) / r ) : T( 0 );
+
+		// mirror
+		x = std::max( x, 2 * ( lb - al ) - x );
+		x = std::min( x, 2 * ( ub + au ) - x );
+
+		// transformation, dl and du are zero in the identity region
+		// lb + al and ub - au are NaN for infinite bounds, in which case the comparisons are false
+		const T dl = x < lb + al ? x - ( lb + al ) : T( 0 );
+		const T du = x > ub - au ? x - ( ub - au ) : T( 0 );
+		const T y = x + dl * dl / T( 4 ) / al - du * du / T( 4 ) / au;
+		return std::min( std::max( y, lb ), ub );
+	}
+
+	/// Inverse of cmaes_boundary_transform, maps y in [lb, ub] to [lb - al, ub + au]; y outside [lb, ub] is clamped.
+	template< typename T >
+	T cmaes_boundary_transform_inverse( T y, T lb, T ub, T al, T au ) {
+		const T xl = ( lb - al ) + 2 * std::sqrt( std::max( al * ( y - lb ), T( 0 ) ) );
+		const T xu = ( ub + au ) - 2 * std::sqrt( std::max( au * ( ub - y ), T( 0 ) ) );
+		return y < lb + al ? xl : ( y > ub - au ? xu : y );
+	}
+
+	/// Reflect x into [lb, ub] by repeatedly mirroring at the bounds (a triangle wave with period 2 * ( ub - lb )).
+	/// Values within bounds are returned unchanged; with an infinite bound, x is mirrored once at the finite bound.
+	template< typename T >
+	T reflective_boundary_transform( T x, T lb, T ub ) {
+		const T w2 = 2 * ( ub - lb );
+		T y = x - w2 * std::floor( ( x - lb ) / w2 );
+		y = std::max( std::min( y, 2 * ub - y ), lb );
+		const T mirrored = x < lb ? 2 * lb - x : 2 * ub - x;
+		y = w2 < std::numeric_limits< T >::infinity() ? y : mirrored;
+		y = w2 > 0 ? y : lb;
+		return ( lb <= x ) & ( x <= ub ) ? x : y;
+	}
+
+	/// Apply an element-wise boundary function to count points of dimension n, stored contiguously row by row.
+	/// Each block of a row is loaded before it is stored, which allows vectorization without alias checks.
+	/// The function is called as f( x, i ), with i the parameter index.
+	template< typename T, size_t VectorBytes = 32, typename F >
+	void cma_apply_rows( size_t n, size_t count, T* x, F f ) {
+		constexpr size_t lanes = VectorBytes / sizeof( T );
+		for ( size_t k = 0; k < count; ++k, x += n )
+		{
+			size_t i = 0;
+			for ( ; i + lanes <= n; i += lanes )
+			{
+				T v[lanes];
+				for ( size_t l = 0; l < lanes; ++l )
+					v[l] = f( x[i + l], i + l );
+				for ( size_t l = 0; l < lanes; ++l )
+					x[i + l] = v[l];
+			}
+			for ( ; i < n; ++i )
+				x[i] = f( x[i], i );
+		}
+	}
+}
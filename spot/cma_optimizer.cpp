@@ -1,4 +1,6 @@
 #include "cma_optimizer.h"
+#include "cma_kernels.h"
+#include "simd_dispatch.h"
 
 #include <algorithm>
 #include <cmath>
@@ -13,8 +15,8 @@
 
 namespace spot
 {
-	using dbl_vec = par_vec;
-	//typedef vector< double > dbl_vec;
+	// internal state is always double precision, regardless of par_t
+	using dbl_vec = vector< double >;
 
 	struct cmaes_random_t
 	{
@@ -92,6 +94,13 @@ namespace spot
 		dbl_vec rgdTmp;  /* temporary (random) vector used in different places */
 		dbl_vec rgFuncValue;
 		dbl_vec publicFitness; /* returned by cmaes_init() */
+		vector< dbl_vec > rgSteps; /* ( x_k - xold ) / sigma of the mu best samples */
+
+		/* single precision sampling */
+		short flgSinglePrecision;
+		short flgSinglePrecisionIsUptodate;
+		vector< vector< float > > Bf;
+		vector< float > Df, zf, dzf, yf;
 
 		double gen; /* Generation number */
 		double countevals;
@@ -103,6 +112,7 @@ namespace spot
 		double minEW;
 
 		short flgEigensysIsUptodate;
+		short flgDiagonalSample; /* current population was sampled with a diagonal covariance */
 		short flgCheckEigen; /* control via cmaes_signals.par */
 		double genOfEigensysUpdate;
 
@@ -258,6 +268,9 @@ namespace spot
 		t->sp.updateCmode.flgalways = 0;
 		t->sp.facupdateCmode = 1;
 
+		t->flgSinglePrecision = 0;
+		t->flgSinglePrecisionIsUptodate = 0;
+
 		int N = t->sp.N;
 
 		if ( t->sp.xstart.empty() ) {
@@ -390,6 +403,14 @@ namespace spot
 			t->B[i].resize( N );
 		}
 		t->index.resize( t->sp.lambda );
+		t->rgSteps.resize( t->sp.mu, dbl_vec( N ) );
+		if ( t->flgSinglePrecision ) {
+			t->Bf.resize( N, vector< float >( N ) );
+			t->Df.resize( N );
+			t->zf.resize( N );
+			t->dzf.resize( N );
+			t->yf.resize( N );
+		}
 		for ( i = 0; i < t->sp.lambda; ++i )
 			t->index[i] = i; /* should not be necessary */
 		t->current_pop.resize( t->sp.lambda );
@@ -793,6 +814,7 @@ namespace spot
 			t->rgD[i] = sqrt( t->rgD[i] );
 
 		t->flgEigensysIsUptodate = 1;
+		t->flgSinglePrecisionIsUptodate = 0;
 		t->genOfEigensysUpdate = t->gen;
 	} /* cmaes_UpdateEigensystem() */
 
@@ -809,11 +831,37 @@ namespace spot
 
 	} /* cmaes_TestMinStdDevs() */
 
+	static void SampleSingle( cmaes_t* t, dbl_vec& x )
+	{
+		/* x = xmean + sigma * B * ( D * z ) */
+		int i, N = t->sp.N;
+		if ( t->flgSinglePrecision ) {
+			if ( !t->flgSinglePrecisionIsUptodate ) {
+				for ( i = 0; i < N; ++i )
+					std::copy( t->B[i].begin(), t->B[i].end(), t->Bf[i].begin() );
+				t->flgSinglePrecisionIsUptodate = 1;
+			}
+			for ( i = 0; i < N; ++i ) {
+				t->Df[i] = float( t->rgD[i] );
+				t->zf[i] = float( cmaes_random_Gauss( &t->rand ) );
+			}
+			simd().transform_sample_float( N, t->Bf, t->Df.data(), t->zf.data(), t->dzf.data(), t->yf.data() );
+			for ( i = 0; i < N; ++i )
+				x[i] = t->current_mean[i] + t->sigma * t->yf[i];
+		}
+		else {
+			for ( i = 0; i < N; ++i )
+				t->rgout[i] = cmaes_random_Gauss( &t->rand );
+			simd().transform_sample( N, t->B, t->rgD.data(), t->rgout.data(), t->rgdTmp.data(), x.data() );
+			for ( i = 0; i < N; ++i )
+				x[i] = t->current_mean[i] + t->sigma * x[i];
+		}
+	}
+
 	const vector< dbl_vec >& cmaes_SamplePopulation( cmaes_t* t )
 	{
-		int iNk, i, j, N = t->sp.N;
+		int iNk, i, N = t->sp.N;
 		int flgdiag = ( ( t->sp.diagonalCov == 1 ) || ( t->sp.diagonalCov >= t->gen ) );
-		double sum;
 		const auto& xmean = t->current_mean;
 
 		/* cmaes_SetMean(t, xmean); * xmean could be changed at this point */
@@ -834,20 +882,13 @@ namespace spot
 		/* treat minimal standard deviations and numeric problems */
 		TestMinStdDevs( t );
 
+		t->flgDiagonalSample = flgdiag;
 		for ( iNk = 0; iNk < t->sp.lambda; ++iNk )
 		{ /* generate scaled cmaes_random vector (D * z)    */
-			for ( i = 0; i < N; ++i )
-				if ( flgdiag )
+			if ( flgdiag )
+				for ( i = 0; i < N; ++i )
 					t->current_pop[iNk][i] = xmean[i] + t->sigma * t->rgD[i] * cmaes_random_Gauss( &t->rand );
-				else
-					t->rgdTmp[i] = t->rgD[i] * cmaes_random_Gauss( &t->rand );
-			if ( !flgdiag )
-				/* add mutation (sigma * B * (D*z)) */
-				for ( i = 0; i < N; ++i ) {
-					for ( j = 0, sum = 0.; j < N; ++j )
-						sum += t->B[i][j] * t->rgdTmp[j];
-					t->current_pop[iNk][i] = xmean[i] + t->sigma * sum;
-				}
+			else SampleSingle( t, t->current_pop[iNk] );
 		}
 		if ( t->state == 3 || t->gen == 0 )
 			++t->gen;
@@ -858,23 +899,18 @@ namespace spot
 
 	const vector< dbl_vec >& cmaes_ReSampleSingle( cmaes_t* t, index_t iindex )
 	{
-		int N = t->sp.N;
-
-		for ( int i = 0; i < N; ++i )
-			t->rgdTmp[i] = t->rgD[i] * cmaes_random_Gauss( &t->rand );
-
-		/* add mutation (sigma * B * (D*z)) */
-		for ( int i = 0; i < N; ++i ) {
-			double sum = 0;
-			for ( int j = 0; j < N; ++j )
-				sum += t->B[i][j] * t->rgdTmp[j];
-
-			t->current_pop[iindex][i] = t->current_mean[i] + t->sigma * sum;
-		}
-
+		SampleSingle( t, t->current_pop[iindex] );
 		return  t->current_pop;
 	}
 
+	double cmaes_ReSampleCoordinate( cmaes_t* t, index_t iindex, index_t i )
+	{
+		// TG: resample a single coordinate of an individual
+		// This is only valid if the population was sampled with a diagonal covariance
+		xo_assert( t->flgDiagonalSample );
+		return t->current_pop[iindex][i] = t->current_mean[i] + t->sigma * t->rgD[i] * cmaes_random_Gauss( &t->rand );
+	}
+
 	const vector< dbl_vec >& cmaes_OverwriteSingle( cmaes_t* t, index_t iindex, const par_vec& params )
 	{
 		// TG: overwrite parameters of a single individual
@@ -885,6 +921,28 @@ namespace spot
 		return  t->current_pop;
 	}
 
+	const vector< dbl_vec >& cmaes_InjectSingle( cmaes_t* t, index_t iindex, const par_vec& params )
+	{
+		// TG: inject an external solution, with its Mahalanobis step length clipped
+		// see Hansen (2011), Injecting External Solutions Into CMA-ES
+		int N = t->sp.N;
+		double norm = 0.;
+		for ( int j = 0; j < N; ++j ) {
+			double sum = 0.;
+			for ( int i = 0; i < N; ++i )
+				sum += t->B[i][j] * ( params[i] - t->current_mean[i] );
+			norm += xo::squared( sum / t->rgD[j] );
+		}
+		norm = sqrt( norm ) / t->sigma;
+
+		double max_norm = sqrt( (double)N ) + 2. * N / ( N + 2. );
+		double f = norm > max_norm ? max_norm / norm : 1.;
+		for ( int i = 0; i < N; ++i )
+			t->current_pop[iindex][i] = t->current_mean[i] + f * ( params[i] - t->current_mean[i] );
+
+		return  t->current_pop;
+	}
+
 	static void Sorted_index( const dbl_vec& rgFunVal, vector< int >& iindex, int n )
 	{
 		int i, j;
@@ -900,7 +958,7 @@ namespace spot
 
 	static void Adapt_C2( cmaes_t* t, int hsig )
 	{
-		int i, j, k, N = t->sp.N;
+		int i, k, N = t->sp.N;
 		int flgdiag = ( ( t->sp.diagonalCov == 1 ) || ( t->sp.diagonalCov >= t->gen ) );
 
 		if ( t->sp.ccov != 0. && t->flgIniphase == 0 ) {
@@ -908,24 +966,15 @@ namespace spot
 			/* definitions for speeding up inner-most loop */
 			double ccov1 = std::min( t->sp.ccov * ( 1. / t->sp.mucov ) * ( flgdiag ? ( N + 1.5 ) / 3. : 1. ), 1. );
 			double ccovmu = std::min( t->sp.ccov * ( 1 - 1. / t->sp.mucov ) * ( flgdiag ? ( N + 1.5 ) / 3. : 1. ), 1. - ccov1 );
-			double sigmasquare = t->sigma * t->sigma;
+			double cold = 1 - ccov1 - ccovmu + ccov1 * ( 1 - hsig ) * t->sp.ccumcov * ( 2. - t->sp.ccumcov );
 
 			t->flgEigensysIsUptodate = 0;
 
-			/* update covariance matrix */
-			for ( i = 0; i < N; ++i )
-				for ( j = flgdiag ? i : 0; j <= i; ++j ) {
-					t->C[i][j] = ( 1 - ccov1 - ccovmu ) * t->C[i][j]
-						+ ccov1
-						* ( t->rgpc[i] * t->rgpc[j]
-							+ ( 1 - hsig ) * t->sp.ccumcov * ( 2. - t->sp.ccumcov ) * t->C[i][j] );
-					for ( k = 0; k < t->sp.mu; ++k ) { /* additional rank mu update */
-						t->C[i][j] += ccovmu * t->sp.weights[k]
-							* ( t->current_pop[t->index[k]][i] - t->rgxold[i] )
-							* ( t->current_pop[t->index[k]][j] - t->rgxold[j] )
-							/ sigmasquare;
-					}
-				}
+			/* update covariance matrix, with additional rank mu update */
+			for ( k = 0; k < t->sp.mu; ++k )
+				for ( i = 0; i < N; ++i )
+					t->rgSteps[k][i] = ( t->current_pop[t->index[k]][i] - t->rgxold[i] ) / t->sigma;
+			simd().update_covariance( N, t->C, cold, ccov1, ccovmu, t->rgpc.data(), t->sp.mu, t->sp.weights.data(), t->rgSteps, flgdiag != 0 );
 			/* update maximal and minimal diagonal value */
 			t->maxdiagC = t->mindiagC = t->C[0][0];
 			for ( i = 1; i < N; ++i ) {
@@ -1074,78 +1123,23 @@ namespace spot
 				xo_error( "Invalid upper and lower bounds for parameter " + xo::to_str( i ) );
 
 			/* between lb+al and ub-au transformation is the identity */
-			t->al[i] = fmin( ( ub[i] - lb[i] ) / 2., ( 1. + fabs( lb[i] ) ) / 20. );
-			t->au[i] = fmin( ( ub[i] - lb[i] ) / 2., ( 1. + fabs( ub[i] ) ) / 20. );
-		}
-	}
-
-	void cmaes_boundary_trans_shift_into_feasible_preimage( cmaes_boundary_trans_t* t, const dbl_vec& x, dbl_vec& y )
-	{
-		auto len = t->lower_bounds.size();
-		for ( size_t i = 0; i < len; ++i ) {
-			double lb, ub, al, au, r, xlow, xup;
-			lb = t->lower_bounds[i];
-			ub = t->upper_bounds[i];
-			al = t->al[i];
-			au = t->au[i];
-			xlow = lb - 2 * al - ( ub - lb ) / 2.0;
-			xup = ub + 2 * au + ( ub - lb ) / 2.0;
-			r = 2 * ( ub - lb + al + au ); /* == xup - xlow == period of the transformation */
-
-			y[i] = x[i];
-
-			if ( y[i] < xlow ) { /* shift up */
-				y[i] += r * ( 1 + (int)( ( xlow - y[i] ) / r ) );
-			}
-			if ( y[i] > xup ) { /* shift down */
-				y[i] -= r * ( 1 + (int)( ( y[i] - xup ) / r ) );
-				/* printf(" \n%f\n", fmod(y[i] - ub - au, r)); */
-			}
-			if ( y[i] < lb - al ) /* mirror */
-				y[i] += 2 * ( lb - al - y[i] );
-			if ( y[i] > ub + au )
-				y[i] -= 2 * ( y[i] - ub - au );
-
-			if ( ( y[i] < lb - al - 1e-15 ) || ( y[i] > ub + au + 1e-15 ) ) {
-				xo_error( xo::stringf( "BUG in cmaes_boundary_transformation_shift_into_feasible_preimage: lb=%f, ub=%f, al=%f au=%f, x=%f, y=%f, i=%d\n", lb, ub, al, au, x[i], y[i], i ) );
-			}
+			t->al[i] = cmaes_boundary_margin( lb[i], ub[i], lb[i] );
+			t->au[i] = cmaes_boundary_margin( lb[i], ub[i], ub[i] );
 		}
 	}
 
 	void cmaes_boundary_trans( cmaes_boundary_trans_t* t, const dbl_vec& x, dbl_vec& y )
 	{
-		auto len = t->lower_bounds.size();
-		cmaes_boundary_trans_shift_into_feasible_preimage( t, x, y );
-		for ( size_t i = 0; i < len; ++i ) {
-			double lb, ub, al, au;
-			lb = t->lower_bounds[i];
-			ub = t->upper_bounds[i];
-			al = t->al[i];
-			au = t->au[i];
-			if ( y[i] < lb + al )
-				y[i] = lb + ( y[i] - ( lb - al ) ) * ( y[i] - ( lb - al ) ) / 4. / al;
-			else if ( y[i] > ub - au )
-				y[i] = ub - ( y[i] - ( ub + au ) ) * ( y[i] - ( ub + au ) ) / 4. / au;
-		}
+		const auto* lb = t->lower_bounds.data(), * ub = t->upper_bounds.data(), * al = t->al.data(), * au = t->au.data();
+		y = x;
+		cma_apply_rows( y.size(), 1, y.data(), [=]( double v, size_t i ) { return cmaes_boundary_transform( v, lb[i], ub[i], al[i], au[i] ); } );
 	}
 
 	void cmaes_boundary_trans_inverse( cmaes_boundary_trans_t* t, const dbl_vec& x, dbl_vec& y )
 	{
-		auto len = t->lower_bounds.size();
-		unsigned long i;
-
-		for ( i = 0; i < len; ++i ) {
-			double lb, ub, al, au;
-			lb = t->lower_bounds[i];
-			ub = t->upper_bounds[i];
-			al = t->al[i];
-			au = t->au[i];
-			y[i] = x[i];
-			if ( y[i] < lb + al )
-				y[i] = ( lb - al ) + 2 * sqrt( al * ( y[i] - lb ) );
-			else if ( y[i] > ub - au )
-				y[i] = ( ub + au ) - 2 * sqrt( au * ( ub - y[i] ) );
-		}
+		const auto* lb = t->lower_bounds.data(), * ub = t->upper_bounds.data(), * al = t->al.data(), * au = t->au.data();
+		y = x;
+		cma_apply_rows( y.size(), 1, y.data(), [=]( double v, size_t i ) { return cmaes_boundary_transform_inverse( v, lb[i], ub[i], al[i], au[i] ); } );
 	}
 
 	struct pimpl_t
@@ -1153,6 +1147,11 @@ namespace spot
 		cmaes_t cmaes;
 		cmaes_boundary_trans_t bounds;
 		search_point_vec bounded_pop;
+		vector< par_vec > injected;
+		cma_bounds_handling bounds_handling;
+		double repair_penalty;
+		dbl_vec repair_distances; /* squared normalized distance between sample and repaired individual */
+		cma_sampling_stats sampling_stats;
 	};
 
 	cma_optimizer::cma_optimizer( const objective& o, evaluator& e, const cma_options& options ) :
@@ -1160,18 +1159,16 @@ namespace spot
 		max_resample_count( 100 )
 	{
 		pimpl = new pimpl_t;
-		auto n = objective_.info().dim();
+		const auto& inf = objective_.info();
+		auto n = inf.dim();
 
-		par_vec mean( n ), std( n ), lb( n ), ub( n );
-		for ( index_t i = 0; i < n; ++i )
+		dbl_vec mean( inf.means().begin(), inf.means().end() ), std( inf.stds().begin(), inf.stds().end() );
+		dbl_vec lb( inf.lower_bounds().begin(), inf.lower_bounds().end() ), ub( inf.upper_bounds().begin(), inf.upper_bounds().end() );
+		if ( !inf.is_feasible( inf.means() ) )
 		{
-			auto& p = objective_.info()[i];
-			if ( !xo::is_between( p.mean, p.min, p.max ) )
-				xo::log::error( "Parameter ", p.name, " initial mean ", p.mean, " is outside range [", p.min, ", ", p.max, "]" );
-			mean[i] = p.mean;
-			std[i] = p.std;
-			lb[i] = p.min;
-			ub[i] = p.max;
+			for ( index_t i = 0; i < n; ++i )
+				if ( auto& p = inf[i]; !xo::is_between( p.mean, p.min, p.max ) )
+					xo::log::error( "Parameter ", p.name, " initial mean ", p.mean, " is outside range [", p.min, ", ", p.max, "]" );
 		}
 
 		// create random seed when zero
@@ -1181,6 +1178,8 @@ namespace spot
 
 		cmaes_init( &pimpl->cmaes, (int)n, mean, std, seed, options.lambda );
 		pimpl->cmaes.sp.updateCmode.modulo = options.update_eigen_modulo;
+		pimpl->cmaes.sp.diagonalCov = options.diagonal_covariance;
+		pimpl->cmaes.flgSinglePrecision = options.single_precision_sampling;
 		if ( n > 0 ) {
 			cmaes_readpara_SupplementDefaults( &pimpl->cmaes );
 			cmaes_init_final( &pimpl->cmaes );
@@ -1188,6 +1187,10 @@ namespace spot
 
 		pimpl->bounded_pop.resize( lambda(), search_point( objective_.info() ) );
 		cmaes_boundary_trans_init( &pimpl->bounds, lb, ub );
+		pimpl->bounds_handling = options.bounds_handling;
+		pimpl->repair_penalty = options.repair_penalty;
+		if ( options.bounds_handling == cma_bounds_handling::transform )
+			set_boundary_transformer( std::make_unique< cmaes_boundary_transformer >( objective_.info() ) );
 		name = o.name() + xo::stringf( ".R%d", random_seed() );
 
 		// add flat fitness condition
@@ -1202,52 +1205,132 @@ namespace spot
 	const search_point_vec& cma_optimizer::sample_population()
 	{
 		XO_PROFILE_FUNCTION( profiler_ );
+		SPOT_TRACE_SCOPE( "cma_optimizer::sample_population" );
 		xo_assert( info().dim() > 0 );
 
 		auto& pop = cmaes_SamplePopulation( &pimpl->cmaes );
+		const auto n = info().dim();
+		auto& stats = pimpl->sampling_stats;
+		stats = cma_sampling_stats();
+		pimpl->repair_distances.assign( pop.size(), 0.0 );
 		for ( index_t ind_idx = 0; ind_idx < pop.size(); ++ind_idx )
 		{
-			par_vec individual( pop[ind_idx].begin(), pop[ind_idx].begin() + info().dim() );
-			bool found_individual = false;
-
-			for ( size_t attempts = 0; !found_individual && attempts < max_resample_count; ++attempts )
+			if ( ind_idx < pimpl->injected.size() )
 			{
-				// apply boundary transformation (if any)
-				try_apply_boundary_transform( individual );
-				if ( !info().is_feasible( individual ) )
-				{
-					cmaes_ReSampleSingle( &pimpl->cmaes, ind_idx );
-					std::copy_n( pop[ind_idx].begin(), info().dim(), individual.begin() );
+				// evaluate the injected candidate itself, the distribution update uses the clipped version
+				// with a boundary transformation, the candidate is injected through its preimage
+				if ( boundary_transformer_ ) {
+					par_vec preimage = pimpl->injected[ind_idx];
+					boundary_transformer_->apply_inverse( preimage );
+					cmaes_InjectSingle( &pimpl->cmaes, ind_idx, preimage );
 				}
-				else found_individual = true;
+				else cmaes_InjectSingle( &pimpl->cmaes, ind_idx, pimpl->injected[ind_idx] );
+				pimpl->bounded_pop[ind_idx].set_values( pimpl->injected[ind_idx] );
+				continue;
 			}
 
-			if ( !found_individual )
+			par_vec individual( pop[ind_idx].begin(), pop[ind_idx].begin() + n );
+			try_apply_boundary_transform( individual );
+			if ( !info().is_feasible( individual ) )
 			{
-				xo::log::warning( "cma_optimizer: no feasible individual found after ", max_resample_count, " attempts, clamping values instead. gen=", current_step(), " ind=", ind_idx );
-				info().clamp( individual );
-				cmaes_OverwriteSingle( &pimpl->cmaes, ind_idx, individual );
+				++stats.infeasible;
+				if ( pimpl->bounds_handling == cma_bounds_handling::repair )
+				{
+					// evaluate the clamped individual, the distribution update uses the original sample with a penalty
+					auto& t = pimpl->cmaes;
+					auto sample = individual;
+					info().clamp_batch( individual.data(), 1 );
+					double dist = 0;
+					for ( index_t i = 0; i < n; ++i )
+						dist += xo::squared( sample[i] - individual[i] ) / ( t.sigma * t.sigma * t.C[i][i] );
+					pimpl->repair_distances[ind_idx] = dist / n;
+					++stats.repaired;
+				}
+				else
+				{
+					// with a diagonal covariance the coordinates are independent, so only infeasible coordinates are resampled
+					const bool coordinate_wise = pimpl->cmaes.flgDiagonalSample && !boundary_transformer_;
+					const auto& lb = info().lower_bounds(), & ub = info().upper_bounds();
+					bool found_individual = false;
+					for ( size_t attempts = 0; !found_individual && attempts < max_resample_count; ++attempts )
+					{
+						if ( coordinate_wise )
+						{
+							for ( index_t i = 0; i < n; ++i ) {
+								if ( individual[i] < lb[i] || individual[i] > ub[i] ) {
+									individual[i] = par_t( cmaes_ReSampleCoordinate( &pimpl->cmaes, ind_idx, i ) );
+									++stats.coordinate_resamples;
+								}
+							}
+						}
+						else
+						{
+							cmaes_ReSampleSingle( &pimpl->cmaes, ind_idx );
+							std::copy_n( pop[ind_idx].begin(), n, individual.begin() );
+							try_apply_boundary_transform( individual );
+							++stats.resamples;
+						}
+						found_individual = info().is_feasible( individual );
+					}
+
+					if ( !found_individual )
+					{
+						info().clamp_batch( individual.data(), 1 );
+						cmaes_OverwriteSingle( &pimpl->cmaes, ind_idx, individual );
+						++stats.repaired;
+					}
+				}
 			}
 
 			pimpl->bounded_pop[ind_idx].set_values( individual );
 		}
 
+		if ( stats.repaired > 0 && pimpl->bounds_handling == cma_bounds_handling::resample )
+			xo::log::warning( "cma_optimizer: clamped ", stats.repaired, " individuals after ", max_resample_count, " attempts; gen=", current_step(),
+				" infeasible=", stats.infeasible, " resamples=", stats.resamples, " coordinate_resamples=", stats.coordinate_resamples );
+		pimpl->injected.clear();
+
 		return pimpl->bounded_pop;
 	}
 
 	void cma_optimizer::update_distribution( const fitness_vec& results )
 	{
 		XO_PROFILE_FUNCTION( profiler_ );
+		SPOT_TRACE_SCOPE( "cma_optimizer::update_distribution" );
 		xo_assert( info().dim() > 0 );
 
+		// negate when maximizing, since c-cmaes always minimizes
+		dbl_vec fitnesses( results.begin(), results.end() );
 		if ( objective_.info().maximize() )
+			std::transform( fitnesses.begin(), fitnesses.end(), fitnesses.begin(), []( double v ) { return -v; } );
+
+		// penalize repaired individuals, scaled with the fitness interquartile range (Hansen et al., 2009)
+		const auto& dist = pimpl->repair_distances;
+		if ( dist.size() == fitnesses.size() && std::any_of( dist.begin(), dist.end(), []( double d ) { return d > 0; } ) )
 		{
-			// negate first, since c-cmaes always minimizes
-			fitness_vec neg_results( results.size() );
-			std::transform( results.begin(), results.end(), neg_results.begin(), [&]( const double& v ) { return -v; } );
-			cmaes_UpdateDistribution( &pimpl->cmaes, neg_results );
+			auto sorted = fitnesses;
+			std::sort( sorted.begin(), sorted.end() );
+			auto iqr = sorted[3 * sorted.size() / 4] - sorted[sorted.size() / 4];
+			if ( iqr <= 0 )
+				iqr = std::max( std::abs( sorted[sorted.size() / 2] ), 1e-12 );
+			for ( index_t i = 0; i < fitnesses.size(); ++i )
+				fitnesses[i] += pimpl->repair_penalty * iqr * dist[i];
 		}
-		else cmaes_UpdateDistribution( &pimpl->cmaes, results );
+		cmaes_UpdateDistribution( &pimpl->cmaes, fitnesses );
+	}
+
+	bool cma_optimizer::inject_candidate( const par_vec& point )
+	{
+		// injected candidates are in parameter space, which is mapped to cma space through the inverse boundary transform
+		if ( ( boundary_transformer_ && !boundary_transformer_->has_inverse() ) || pimpl->injected.size() >= size_t( lambda() ) || !info().is_feasible( point ) )
+			return false;
+		pimpl->injected.push_back( point );
+		return true;
+	}
+
+	const cma_sampling_stats& cma_optimizer::sampling_stats() const
+	{
+		return pimpl->sampling_stats;
 	}
 
 	par_vec cma_optimizer::current_mean() const
@@ -1268,7 +1351,10 @@ namespace spot
 
 	vector< par_vec > cma_optimizer::current_covariance() const
 	{
-		return pimpl->cmaes.C;
+		vector< par_vec > cov;
+		for ( const auto& row : pimpl->cmaes.C )
+			cov.emplace_back( row.begin(), row.end() );
+		return cov;
 	}
 
 	void cma_optimizer::save_state( const path& filename ) const
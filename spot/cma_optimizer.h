@@ -7,11 +7,29 @@ namespace spot
 {
 	enum class cma_weights { equal = 0, linear = 1, log = 2 };
 
+	/// handling of samples outside the parameter bounds:
+	/// resample: draw new samples, or only the infeasible coordinates when the covariance is diagonal
+	/// repair: evaluate the clamped sample, and update the distribution with the original sample and a penalty
+	/// transform: use a cmaes_boundary_transformer, so that all samples are feasible
+	enum class cma_bounds_handling { resample = 0, repair = 1, transform = 2 };
+
 	struct cma_options {
 		int lambda = 0;
 		long random_seed = 123;
 		cma_weights weights = cma_weights::log; // #todo: this setting is currently ignored :S
 		double update_eigen_modulo = -1;
+		bool single_precision_sampling = false; // sample using a float copy of the eigenvectors, which is faster for large dimensions
+		double diagonal_covariance = 0; // number of initial generations with a diagonal covariance, 1 for always, -1 for automatic
+		cma_bounds_handling bounds_handling = cma_bounds_handling::resample;
+		double repair_penalty = 1.0; // penalty per squared normalized repair distance, relative to the fitness interquartile range
+	};
+
+	/// statistics of the samples outside the parameter bounds in the current generation
+	struct cma_sampling_stats {
+		size_t infeasible = 0; // samples that were initially outside bounds
+		size_t resamples = 0; // full resamples, O(N^2) each
+		size_t coordinate_resamples = 0; // single coordinate resamples, only with a diagonal covariance
+		size_t repaired = 0; // samples clamped into bounds
 	};
 
 	class SPOT_API cma_optimizer : public optimizer
@@ -23,9 +41,11 @@ namespace spot
 		// optimization
 		const search_point_vec& sample_population();
 		void update_distribution( const fitness_vec& results );
+		virtual bool inject_candidate( const par_vec& point ) override;
 
 		// analysis
 		par_vec current_mean() const;
+		const cma_sampling_stats& sampling_stats() const;
 		par_vec current_std() const;
 		vector< par_vec > current_covariance() const;
 
@@ -0,0 +1,87 @@
+#include "cpu_token_pool.h"
+
+#include "xo/system/assert.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+#	define NOMINMAX
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <semaphore.h>
+#endif
+
+namespace spot
+{
+#ifdef _WIN32
+	static string semaphore_name( const string& name ) { return "Local\\" + name; }
+#else
+	static string semaphore_name( const string& name ) { return "/" + name; }
+#endif
+
+	cpu_token_pool::cpu_token_pool( const string& name, size_t tokens ) :
+		name_( name ),
+		handle_( nullptr )
+	{
+		if ( tokens == 0 )
+			tokens = std::max( 1u, std::thread::hardware_concurrency() );
+#ifdef _WIN32
+		handle_ = CreateSemaphoreA( NULL, LONG( tokens ), LONG( tokens ), semaphore_name( name ).c_str() );
+		xo_error_if( !handle_, "Could not open cpu token pool " + name );
+#else
+		auto* sem = sem_open( semaphore_name( name ).c_str(), O_CREAT, 0666, unsigned( tokens ) );
+		xo_error_if( sem == SEM_FAILED, "Could not open cpu token pool " + name + ": " + std::strerror( errno ) );
+		handle_ = sem;
+#endif
+	}
+
+	cpu_token_pool::~cpu_token_pool()
+	{
+#ifdef _WIN32
+		CloseHandle( handle_ );
+#else
+		sem_close( static_cast<sem_t*>( handle_ ) );
+#endif
+	}
+
+	void cpu_token_pool::acquire()
+	{
+#ifdef _WIN32
+		WaitForSingleObject( handle_, INFINITE );
+#else
+		while ( sem_wait( static_cast<sem_t*>( handle_ ) ) != 0 )
+			xo_error_if( errno != EINTR, "Could not acquire cpu token: " + string( std::strerror( errno ) ) );
+#endif
+	}
+
+	bool cpu_token_pool::try_acquire()
+	{
+#ifdef _WIN32
+		return WaitForSingleObject( handle_, 0 ) == WAIT_OBJECT_0;
+#else
+		while ( sem_trywait( static_cast<sem_t*>( handle_ ) ) != 0 )
+			if ( errno != EINTR )
+				return false;
+		return true;
+#endif
+	}
+
+	void cpu_token_pool::release()
+	{
+#ifdef _WIN32
+		ReleaseSemaphore( handle_, 1, NULL );
+#else
+		sem_post( static_cast<sem_t*>( handle_ ) );
+#endif
+	}
+
+	void cpu_token_pool::remove( const string& name )
+	{
+#ifndef _WIN32
+		sem_unlink( semaphore_name( name ).c_str() ); // windows semaphores are removed with their last handle
+#endif
+	}
+}
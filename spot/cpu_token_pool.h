@@ -0,0 +1,47 @@
+#pragma once
+
+#include "spot_types.h"
+
+namespace spot
+{
+	/// Machine-wide pool of cpu tokens, shared between processes through a named semaphore.
+	/// Evaluators that acquire a token for each evaluation keep the total number of concurrent
+	/// evaluations of all processes that use the same pool below the number of tokens.
+	/// The number of tokens is set by the process that creates the pool; tokens held by a process
+	/// that crashes are not returned, use remove() to reset the pool.
+	class SPOT_API cpu_token_pool
+	{
+	public:
+		/// Open or create a pool, tokens = 0 uses the number of hardware threads.
+		cpu_token_pool( const string& name = "spot_cpu_tokens", size_t tokens = 0 );
+		~cpu_token_pool();
+		cpu_token_pool( const cpu_token_pool& ) = delete;
+		cpu_token_pool& operator=( const cpu_token_pool& ) = delete;
+
+		void acquire();
+		bool try_acquire();
+		void release();
+
+		const string& name() const { return name_; }
+
+		/// Remove the named pool, processes that have it opened can still use it.
+		static void remove( const string& name );
+
+	private:
+		string name_;
+		void* handle_;
+	};
+
+	/// Holds a token of a cpu_token_pool until destruction, pool can be null.
+	class cpu_token
+	{
+	public:
+		cpu_token( cpu_token_pool* pool ) : pool_( pool ) { if ( pool_ ) pool_->acquire(); }
+		~cpu_token() { if ( pool_ ) pool_->release(); }
+		cpu_token( const cpu_token& ) = delete;
+		cpu_token& operator=( const cpu_token& ) = delete;
+
+	private:
+		cpu_token_pool* pool_;
+	};
+}
@@ -2,8 +2,13 @@
 
 #include "objective.h"
 #include <functional>
+#include <type_traits>
 #include "xo/container/storage.h"
 #include "par_info.h"
+#include "task_scheduler.h"
+#include "data_source.h"
+#include "minibatch_objective.h"
+#include <atomic>
 
 namespace spot
 {
@@ -22,8 +27,16 @@ namespace spot
 		const spot::search_point& p;
 	};
 
+	/// Models can evaluate a batch of inputs at once by implementing evaluate( const input_t* x, output_t* y, size_t n ) const.
+	template< typename ModelT, typename = void >
+	struct has_batch_evaluate : std::false_type {};
+
+	template< typename ModelT >
+	struct has_batch_evaluate< ModelT, std::void_t< decltype( std::declval< const ModelT& >().evaluate(
+		std::declval< const typename ModelT::input_t* >(), std::declval< typename ModelT::output_t* >(), size_t() ) ) > > : std::true_type {};
+
 	template< typename ModelT >
-	class data_objective : public objective
+	class data_objective : public objective, public minibatch_objective
 	{
 	public:
 		using input_t = typename ModelT::input_t;
@@ -31,20 +44,128 @@ namespace spot
 		using pair_t = typename std::pair<input_t, output_t>;
 		using container_t = typename std::vector<pair_t>;
 
-		data_objective( const container_t& data ) :
-			objective( make_objective_info( ModelT::mean(), ModelT::stdev(), ModelT::lower(), ModelT::upper() ) ),
-			data_( data )
+		using source_t = data_source< input_t, output_t >;
+
+		/// The samples are moved into separate input and output arrays, pass an rvalue to avoid copying the data set.
+		data_objective( container_t data ) :
+			data_objective( make_source( std::move( data ) ) )
+		{}
+
+		data_objective( vector< input_t > inputs, vector< output_t > outputs ) :
+			data_objective( std::make_shared< vector_data_source< input_t, output_t > >( std::move( inputs ), std::move( outputs ) ) )
 		{}
 
+		/// Use a shared source, e.g. a mapped_data_source.
+		data_objective( s_ptr< const source_t > source ) :
+			objective( make_objective_info( ModelT::mean(), ModelT::stdev(), ModelT::lower(), ModelT::upper() ) ),
+			source_( std::move( source ) )
+		{
+			xo_error_if( !source_, "No data source" );
+		}
+
+		const source_t& source() const { return *source_; }
+
+		/// Number of samples per task, the result only depends on the grain size and not on the number of threads.
+		void set_grain_size( size_t grain_size ) { grain_size_ = grain_size; }
+
+		/// Minibatches consist of randomly selected blocks of consecutive samples.
+		void set_minibatch_block_size( size_t block_size ) { minibatch_block_size_ = std::max< size_t >( 1, block_size ); }
+
+		void set_minibatch( size_t samples, uint64_t seed ) override {
+			const auto blocks = ( source_->size() + minibatch_block_size_ - 1 ) / minibatch_block_size_;
+			const auto count = ( samples + minibatch_block_size_ - 1 ) / minibatch_block_size_;
+			if ( count < blocks )
+				minibatch_blocks_ = select_minibatch_blocks( blocks, count, seed );
+			else minibatch_blocks_.clear();
+		}
+		void set_full_batch() override { minibatch_blocks_.clear(); }
+		size_t minibatch_size() const override {
+			if ( minibatch_blocks_.empty() )
+				return source_->size();
+			size_t n = minibatch_blocks_.size() * minibatch_block_size_;
+			auto tail = source_->size() % minibatch_block_size_; // the last block may be incomplete
+			if ( tail != 0 && minibatch_blocks_.back() == source_->size() / minibatch_block_size_ )
+				n -= minibatch_block_size_ - tail;
+			return n;
+		}
+		size_t sample_count() const override { return source_->size(); }
+		size_t sample_evaluations() const override { return sample_evaluations_; }
+
+		using objective::evaluate;
 		virtual fitness_t evaluate( const search_point& point ) const override {
 			ModelT model( point );
-			fitness_t result = 0;
-			for ( const auto& [x, y] : data_ )
-				result += xo::squared( model( x ) - y );
-			return result / data_.size();
+			auto error_sum = [&]( size_t begin, size_t end ) {
+				auto sum = chunk_error( model, source_->chunk( begin, end ) );
+				source_->release( begin, end );
+				return sum;
+			};
+			auto add = []( fitness_t a, fitness_t b ) { return a + b; };
+
+			const auto samples = minibatch_size();
+			sample_evaluations_ += samples;
+			if ( minibatch_blocks_.empty() )
+				return task_scheduler::current().parallel_reduce( samples, grain_size_, fitness_t( 0 ), error_sum, add ) / samples;
+
+			const auto block_grain = std::max< size_t >( 1, grain_size_ / minibatch_block_size_ );
+			auto result = task_scheduler::current().parallel_reduce( minibatch_blocks_.size(), block_grain, fitness_t( 0 ),
+				[&]( size_t first, size_t last ) {
+					fitness_t sum = 0;
+					for ( auto b = first; b < last; ++b )
+					{
+						auto begin = minibatch_blocks_[b] * minibatch_block_size_;
+						sum += error_sum( begin, std::min( begin + minibatch_block_size_, source_->size() ) );
+					}
+					return sum;
+				}, add );
+			return result / samples;
 		}
 
 	private:
-		const container_t& data_;
+		static s_ptr< const source_t > make_source( container_t data ) {
+			vector< input_t > inputs;
+			vector< output_t > outputs;
+			inputs.reserve( data.size() );
+			outputs.reserve( data.size() );
+			for ( auto& [x, y] : data )
+			{
+				inputs.push_back( std::move( x ) );
+				outputs.push_back( std::move( y ) );
+			}
+			return std::make_shared< vector_data_source< input_t, output_t > >( std::move( inputs ), std::move( outputs ) );
+		}
+
+		static fitness_t chunk_error( const ModelT& model, const typename source_t::chunk_t& c ) {
+			if constexpr ( has_batch_evaluate< ModelT >::value )
+			{
+				thread_local vector< output_t > predictions;
+				predictions.resize( c.size );
+				model.evaluate( c.inputs, predictions.data(), c.size );
+				return squared_error_sum( [&]( size_t i ) { return predictions[i]; }, c.outputs, c.size );
+			}
+			else return squared_error_sum( [&]( size_t i ) { return model( c.inputs[i] ); }, c.outputs, c.size );
+		}
+
+		// independent accumulators allow vectorization, while keeping a fixed summation order
+		template< typename PredictF >
+		static fitness_t squared_error_sum( PredictF predict, const output_t* target, size_t n ) {
+			constexpr size_t lanes = 8;
+			fitness_t acc[lanes] = {};
+			size_t i = 0;
+			for ( ; i + lanes <= n; i += lanes )
+				for ( size_t l = 0; l < lanes; ++l )
+					acc[l] += xo::squared( fitness_t( predict( i + l ) - target[i + l] ) );
+			for ( ; i < n; ++i )
+				acc[i % lanes] += xo::squared( fitness_t( predict( i ) - target[i] ) );
+			fitness_t sum = 0;
+			for ( auto a : acc )
+				sum += a;
+			return sum;
+		}
+
+		s_ptr< const source_t > source_;
+		size_t grain_size_ = 4096;
+		size_t minibatch_block_size_ = 64;
+		vector< size_t > minibatch_blocks_;
+		mutable std::atomic< size_t > sample_evaluations_ = 0;
 	};
 }
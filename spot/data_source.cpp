@@ -0,0 +1,53 @@
+#include "data_source.h"
+#include "binary_io.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace spot
+{
+	static const char data_file_magic[8] = { 'S', 'P', 'O', 'T', 'D', 'A', 'T', 'A' };
+	static const uint32_t data_file_version = 1;
+	static const size_t data_file_header_size = sizeof( data_file_magic ) + 4 * sizeof( uint32_t ) + sizeof( uint64_t );
+
+	static size_t align_offset( size_t offset ) {
+		return ( offset + data_file_alignment - 1 ) / data_file_alignment * data_file_alignment;
+	}
+
+	data_file_layout::data_file_layout( size_t in_size, size_t out_size, size_t count ) :
+		input_size( in_size ),
+		output_size( out_size ),
+		samples( count ),
+		inputs_offset( align_offset( data_file_header_size ) ),
+		outputs_offset( align_offset( inputs_offset + count * in_size ) ),
+		file_size( outputs_offset + count * out_size )
+	{}
+
+	void data_file_layout::write_header( std::ostream& str ) const
+	{
+		str.write( data_file_magic, sizeof( data_file_magic ) );
+		write_binary( str, data_file_version );
+		write_binary( str, uint32_t( input_size ) );
+		write_binary( str, uint32_t( output_size ) );
+		write_binary( str, uint32_t( 0 ) ); // reserved
+		write_binary( str, uint64_t( samples ) );
+	}
+
+	data_file_layout data_file_layout::read_header( const char* data, size_t size, const string& filename )
+	{
+		xo_error_if( size < data_file_header_size || std::memcmp( data, data_file_magic, sizeof( data_file_magic ) ) != 0,
+			filename + " is not a data file" );
+		auto read = [&]( auto& v, size_t offset ) { std::memcpy( &v, data + offset, sizeof( v ) ); };
+		uint32_t version, in_size, out_size;
+		uint64_t count;
+		read( version, 8 );
+		read( in_size, 12 );
+		read( out_size, 16 );
+		read( count, 24 );
+		xo_error_if( version != data_file_version, "Unsupported data file version in " + filename );
+
+		data_file_layout layout( in_size, out_size, size_t( count ) );
+		xo_error_if( size < layout.file_size, "Data file " + filename + " is incomplete" );
+		return layout;
+	}
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "spot_types.h"
+#include "mapped_file.h"
+#include "xo/system/assert.h"
+#include <fstream>
+#include <type_traits>
+
+namespace spot
+{
+	/// Contiguous inputs and outputs of a range of samples.
+	template< typename InputT, typename OutputT >
+	struct data_chunk {
+		const InputT* inputs;
+		const OutputT* outputs;
+		size_t size;
+	};
+
+	/// Samples used by data_objective, accessed in chunks.
+	/// Chunks remain valid for the lifetime of the source, and may be requested concurrently from multiple threads.
+	template< typename InputT, typename OutputT >
+	class data_source
+	{
+	public:
+		using input_t = InputT;
+		using output_t = OutputT;
+		using chunk_t = data_chunk< InputT, OutputT >;
+
+		virtual ~data_source() = default;
+		virtual size_t size() const = 0;
+		virtual chunk_t chunk( size_t begin, size_t end ) const = 0;
+
+		/// Called after a chunk is processed, sources that are not resident can release its memory.
+		virtual void release( size_t begin, size_t end ) const {}
+	};
+
+	/// Samples stored in memory.
+	template< typename InputT, typename OutputT >
+	class vector_data_source : public data_source< InputT, OutputT >
+	{
+	public:
+		using chunk_t = data_chunk< InputT, OutputT >;
+
+		vector_data_source( vector< InputT > inputs, vector< OutputT > outputs ) :
+			inputs_( std::move( inputs ) ),
+			outputs_( std::move( outputs ) )
+		{
+			xo_error_if( inputs_.size() != outputs_.size(), "Number of inputs and outputs do not match" );
+		}
+
+		size_t size() const override { return inputs_.size(); }
+		chunk_t chunk( size_t begin, size_t end ) const override { return { inputs_.data() + begin, outputs_.data() + begin, end - begin }; }
+
+		const vector< InputT >& inputs() const { return inputs_; }
+		const vector< OutputT >& outputs() const { return outputs_; }
+
+	private:
+		vector< InputT > inputs_;
+		vector< OutputT > outputs_;
+	};
+
+	/// Layout of a binary data file:
+	/// header (magic, version, input size, output size, sample count), inputs, outputs.
+	/// Inputs and outputs are stored in native byte order and start at a multiple of data_file_alignment.
+	struct SPOT_API data_file_layout {
+		size_t input_size = 0;
+		size_t output_size = 0;
+		size_t samples = 0;
+		size_t inputs_offset = 0;
+		size_t outputs_offset = 0;
+		size_t file_size = 0;
+
+		data_file_layout() = default;
+		data_file_layout( size_t in_size, size_t out_size, size_t count );
+
+		void write_header( std::ostream& str ) const;
+		static data_file_layout read_header( const char* data, size_t size, const string& filename );
+	};
+	constexpr size_t data_file_alignment = 64;
+
+	/// Write samples to a binary data file that can be opened with mapped_data_source.
+	template< typename InputT, typename OutputT >
+	void write_data_file( const path& filename, const vector< InputT >& inputs, const vector< OutputT >& outputs ) {
+		static_assert( std::is_trivially_copyable_v< InputT > && std::is_trivially_copyable_v< OutputT > );
+		xo_error_if( inputs.size() != outputs.size(), "Number of inputs and outputs do not match" );
+		std::ofstream str( filename.str(), std::ios::binary );
+		xo_error_if( !str.good(), "Could not open " + filename.str() );
+		data_file_layout layout( sizeof( InputT ), sizeof( OutputT ), inputs.size() );
+		layout.write_header( str );
+		while ( size_t( str.tellp() ) < layout.inputs_offset ) str.put( 0 );
+		str.write( reinterpret_cast<const char*>( inputs.data() ), inputs.size() * sizeof( InputT ) );
+		while ( size_t( str.tellp() ) < layout.outputs_offset ) str.put( 0 );
+		str.write( reinterpret_cast<const char*>( outputs.data() ), outputs.size() * sizeof( OutputT ) );
+		xo_error_if( !str.good(), "Error writing " + filename.str() );
+	}
+
+	/// Samples in a memory-mapped binary data file, see write_data_file().
+	/// The mapping is shared by all threads, and between processes through the system page cache.
+	/// Files can be larger than physical memory, pages are loaded when chunks are accessed.
+	template< typename InputT, typename OutputT >
+	class mapped_data_source : public data_source< InputT, OutputT >
+	{
+	public:
+		using chunk_t = data_chunk< InputT, OutputT >;
+		static_assert( std::is_trivially_copyable_v< InputT > && std::is_trivially_copyable_v< OutputT > );
+
+		/// If streaming is set, the pages of processed chunks are released, to keep memory usage low for large files.
+		mapped_data_source( const path& filename, bool streaming = false ) :
+			file_( filename ),
+			layout_( data_file_layout::read_header( file_.data(), file_.size(), filename.str() ) ),
+			streaming_( streaming )
+		{
+			xo_error_if( layout_.input_size != sizeof( InputT ) || layout_.output_size != sizeof( OutputT ),
+				"Sample types do not match data file " + filename.str() );
+		}
+
+		size_t size() const override { return layout_.samples; }
+		chunk_t chunk( size_t begin, size_t end ) const override {
+			if ( streaming_ )
+			{
+				file_.will_need( layout_.inputs_offset + begin * sizeof( InputT ), ( end - begin ) * sizeof( InputT ) );
+				file_.will_need( layout_.outputs_offset + begin * sizeof( OutputT ), ( end - begin ) * sizeof( OutputT ) );
+			}
+			return { inputs() + begin, outputs() + begin, end - begin };
+		}
+		void release( size_t begin, size_t end ) const override {
+			if ( streaming_ )
+			{
+				file_.dont_need( layout_.inputs_offset + begin * sizeof( InputT ), ( end - begin ) * sizeof( InputT ) );
+				file_.dont_need( layout_.outputs_offset + begin * sizeof( OutputT ), ( end - begin ) * sizeof( OutputT ) );
+			}
+		}
+
+		const mapped_file& file() const { return file_; }
+
+	private:
+		const InputT* inputs() const { return reinterpret_cast<const InputT*>( file_.data() + layout_.inputs_offset ); }
+		const OutputT* outputs() const { return reinterpret_cast<const OutputT*>( file_.data() + layout_.outputs_offset ); }
+
+		mapped_file file_;
+		data_file_layout layout_;
+		bool streaming_;
+	};
+}
@@ -78,6 +78,7 @@ namespace spot
 	void eva_optimizer::sample_population()
 	{
 		XO_PROFILE_FUNCTION( profiler_ );
+		SPOT_TRACE_SCOPE( "eva_optimizer::sample_population" );
 
 		auto ev_distrib = std::normal_distribution( options_.ev_offset, options_.ev_stdev );
 		const auto n = info().dim();
@@ -99,6 +100,7 @@ namespace spot
 	void eva_optimizer::update_distribution()
 	{
 		XO_PROFILE_FUNCTION( profiler_ );
+		SPOT_TRACE_SCOPE( "eva_optimizer::update_distribution" );
 
 		const auto n = info().dim();
 		auto order = xo::sorted_indices( current_step_fitnesses_, [&]( auto a, auto b ) { return info().is_better( a, b ); } );
@@ -2,25 +2,61 @@
 
 #include "objective.h"
 #include "xo/system/system_tools.h"
+#include "tracer.h"
 #include "spot/search_point.h"
 #include "async_evaluator.h"
 #include "pooled_evaluator.h"
+#include <cstdlib>
 
 namespace spot
 {
 	evaluator& default_evaluator()
 	{
+		// share cpus with other processes if SPOT_CPU_TOKEN_POOL contains a pool name
+		static auto s_token_pool = []() -> u_ptr< cpu_token_pool > {
+			if ( auto* name = std::getenv( "SPOT_CPU_TOKEN_POOL" ); name && *name )
+				return std::make_unique< cpu_token_pool >( name );
+			return nullptr;
+		}();
 		static auto s_default_evaluator = pooled_evaluator();
+		s_default_evaluator.set_cpu_token_pool( s_token_pool.get() );
 		return s_default_evaluator;
 	}
 
+	vector< double >& evaluator::thread_evaluation_durations()
+	{
+		thread_local vector< double > durations;
+		return durations;
+	}
+
 	vector< result<fitness_t> > sequential_evaluator::evaluate( const objective& o, const search_point_vec& point_vec, const xo::stop_token& st, priority_t prio )
 	{
-		// single threaded evaluation
+		// single threaded evaluation, contexts are kept per calling thread
+		thread_local objective_context_cache context_cache;
+		auto* context = context_cache.get( o );
+		auto& durations = thread_evaluation_durations();
+		durations.resize( point_vec.size() );
+		metrics_.set_workers( 1 );
+		vector< evaluator_metrics::task > tasks;
+		tasks.reserve( point_vec.size() );
+		for ( index_t i = 0; i < point_vec.size(); ++i )
+			tasks.push_back( metrics_.queue_task() );
 		vector< result<fitness_t> > results;
 		results.reserve( point_vec.size() );
-		for ( const auto& sp : point_vec )
-			results.push_back( o.evaluate_noexcept( sp, st ) );
+		for ( index_t i = 0; i < point_vec.size(); ++i )
+		{
+			if ( st.stop_requested() )
+			{
+				metrics_.cancel_task( tasks[i] );
+				results.push_back( xo::error_message( evaluation_cancelled_message ) );
+				durations[i] = 0;
+				continue;
+			}
+			SPOT_TRACE_SCOPE( "evaluator::evaluate" );
+			metrics_.start_task( tasks[i] );
+			results.push_back( o.evaluate_noexcept( point_vec[i], st, context ) );
+			durations[i] = metrics_.finish_task( tasks[i], !results.back() );
+		}
 
 		return results;
 	}
@@ -4,15 +4,30 @@
 #include "xo/utility/result.h"
 #include "xo/thread/stop_token.h"
 #include "search_point.h"
+#include "evaluator_metrics.h"
 
 namespace spot
 {
+	/// Error message of evaluations that are skipped after a stop request.
+	inline constexpr const char* evaluation_cancelled_message = "Evaluation cancelled";
+
 	class SPOT_API evaluator
 	{
 	public:
 		evaluator() = default;
 		virtual ~evaluator() = default;
 		virtual vector< result<fitness_t> > evaluate( const objective& o, const search_point_vec& point_vec, const xo::stop_token& st, priority_t prio = 0 ) = 0;
+
+		/// Duration in seconds of each evaluation in the last call to evaluate() from the current thread.
+		/// Evaluators that do not measure durations leave this unchanged.
+		static vector< double >& thread_evaluation_durations();
+
+		/// Counters and histograms of the evaluations performed by this evaluator.
+		evaluator_metrics& metrics() { return metrics_; }
+		const evaluator_metrics& metrics() const { return metrics_; }
+
+	protected:
+		evaluator_metrics metrics_;
 	};
 
 	class SPOT_API sequential_evaluator : public evaluator
@@ -0,0 +1,154 @@
+#include "evaluator_metrics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef _WIN32
+#	define NOMINMAX
+#	include <windows.h>
+#else
+#	include <time.h>
+#endif
+
+namespace spot
+{
+	// cpu time of the calling thread, in seconds
+	static double thread_cpu_time()
+	{
+#ifdef _WIN32
+		FILETIME creation, exit, kernel, user;
+		GetThreadTimes( GetCurrentThread(), &creation, &exit, &kernel, &user );
+		auto to_100ns = []( const FILETIME& ft ) { return ( uint64_t( ft.dwHighDateTime ) << 32 ) | ft.dwLowDateTime; };
+		return 1e-7 * double( to_100ns( kernel ) + to_100ns( user ) );
+#else
+		timespec ts;
+		clock_gettime( CLOCK_THREAD_CPUTIME_ID, &ts );
+		return double( ts.tv_sec ) + 1e-9 * double( ts.tv_nsec );
+#endif
+	}
+
+	double histogram_snapshot::percentile( double p ) const
+	{
+		if ( total == 0 )
+			return 0.0;
+		auto target = std::max< uint64_t >( 1, uint64_t( std::ceil( p * double( total ) ) ) );
+		uint64_t count = 0;
+		for ( index_t i = 0; i < counts.size(); ++i )
+			if ( ( count += counts[i] ) >= target )
+				return latency_histogram::bucket_limit( i );
+		return latency_histogram::bucket_limit( counts.size() - 1 );
+	}
+
+	void latency_histogram::add( std::chrono::nanoseconds d )
+	{
+		// bucket 0 is < 1us, bucket i is [2^(i-1), 2^i) us
+		auto us = uint64_t( std::max< std::chrono::nanoseconds::rep >( 0, d.count() ) / 1000 );
+		index_t idx = 0;
+		while ( us > 0 && idx < bucket_count - 1 )
+		{
+			us >>= 1;
+			++idx;
+		}
+		counts_[idx].fetch_add( 1, std::memory_order_relaxed );
+		sum_ns_.fetch_add( uint64_t( std::max< std::chrono::nanoseconds::rep >( 0, d.count() ) ), std::memory_order_relaxed );
+	}
+
+	histogram_snapshot latency_histogram::snapshot() const
+	{
+		histogram_snapshot s;
+		s.counts.reserve( bucket_count );
+		for ( auto& c : counts_ )
+		{
+			s.counts.push_back( c.load( std::memory_order_relaxed ) );
+			s.total += s.counts.back();
+		}
+		s.sum = 1e-9 * double( sum_ns_.load( std::memory_order_relaxed ) );
+		return s;
+	}
+
+	void latency_histogram::reset()
+	{
+		for ( auto& c : counts_ )
+			c.store( 0, std::memory_order_relaxed );
+		sum_ns_.store( 0, std::memory_order_relaxed );
+	}
+
+	double latency_histogram::bucket_limit( index_t idx )
+	{
+		return 1e-6 * std::ldexp( 1.0, int( idx ) );
+	}
+
+	evaluator_metrics::evaluator_metrics() :
+		evaluations_( 0 ),
+		errors_( 0 ),
+		cancelled_( 0 ),
+		in_flight_( 0 ),
+		workers_( 0 ),
+		busy_ns_( 0 ),
+		cpu_ns_( 0 ),
+		reset_time_( clock::now().time_since_epoch().count() )
+	{}
+
+	evaluator_metrics::task evaluator_metrics::queue_task()
+	{
+		in_flight_.fetch_add( 1, std::memory_order_relaxed );
+		return task{ clock::now() };
+	}
+
+	void evaluator_metrics::start_task( task& t )
+	{
+		t.started = clock::now();
+		t.cpu_started = thread_cpu_time();
+		queue_wait_.add( t.started - t.queued );
+	}
+
+	double evaluator_metrics::finish_task( const task& t, bool error )
+	{
+		auto cpu = thread_cpu_time() - t.cpu_started;
+		auto duration = clock::now() - t.started;
+		execution_.add( duration );
+		busy_ns_.fetch_add( uint64_t( std::chrono::duration_cast< std::chrono::nanoseconds >( duration ).count() ), std::memory_order_relaxed );
+		cpu_ns_.fetch_add( uint64_t( std::max( 0.0, cpu ) * 1e9 ), std::memory_order_relaxed );
+		if ( error )
+			errors_.fetch_add( 1, std::memory_order_relaxed );
+		evaluations_.fetch_add( 1, std::memory_order_relaxed );
+		in_flight_.fetch_sub( 1, std::memory_order_relaxed );
+		return std::chrono::duration< double >( duration ).count();
+	}
+
+	void evaluator_metrics::cancel_task( const task& t )
+	{
+		cancelled_.fetch_add( 1, std::memory_order_relaxed );
+		in_flight_.fetch_sub( 1, std::memory_order_relaxed );
+	}
+
+	evaluator_metrics_snapshot evaluator_metrics::snapshot() const
+	{
+		evaluator_metrics_snapshot s;
+		s.evaluations = evaluations_.load( std::memory_order_relaxed );
+		s.errors = errors_.load( std::memory_order_relaxed );
+		s.cancelled = cancelled_.load( std::memory_order_relaxed );
+		s.in_flight = in_flight_.load( std::memory_order_relaxed );
+		s.workers = workers_.load( std::memory_order_relaxed );
+		auto reset_time = clock::time_point( clock::duration( reset_time_.load( std::memory_order_relaxed ) ) );
+		s.wall_time = std::chrono::duration< double >( clock::now() - reset_time ).count();
+		s.busy_time = 1e-9 * double( busy_ns_.load( std::memory_order_relaxed ) );
+		s.cpu_time = 1e-9 * double( cpu_ns_.load( std::memory_order_relaxed ) );
+		s.queue_wait = queue_wait_.snapshot();
+		s.execution = execution_.snapshot();
+		return s;
+	}
+
+	void evaluator_metrics::reset()
+	{
+		// in-flight tasks and workers describe the current state and are not reset
+		evaluations_.store( 0, std::memory_order_relaxed );
+		errors_.store( 0, std::memory_order_relaxed );
+		cancelled_.store( 0, std::memory_order_relaxed );
+		busy_ns_.store( 0, std::memory_order_relaxed );
+		cpu_ns_.store( 0, std::memory_order_relaxed );
+		reset_time_.store( clock::now().time_since_epoch().count(), std::memory_order_relaxed );
+		queue_wait_.reset();
+		execution_.reset();
+	}
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "spot_types.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+
+namespace spot
+{
+	/// Copy of the bucket counts of a latency_histogram.
+	struct SPOT_API histogram_snapshot
+	{
+		vector< uint64_t > counts;
+		uint64_t total = 0;
+		double sum = 0; // in seconds
+
+		double mean() const { return total > 0 ? sum / total : 0.0; }
+		/// Upper bound of the bucket that contains the given fraction of samples, in seconds.
+		double percentile( double p ) const;
+	};
+
+	/// Lock-free histogram of durations, with power-of-two buckets from 1us to ~6 days.
+	class SPOT_API latency_histogram
+	{
+	public:
+		static constexpr size_t bucket_count = 40;
+
+		void add( std::chrono::nanoseconds d );
+		histogram_snapshot snapshot() const;
+		void reset();
+
+		/// Upper bound of bucket idx, in seconds.
+		static double bucket_limit( index_t idx );
+
+	private:
+		std::array< std::atomic< uint64_t >, bucket_count > counts_{};
+		std::atomic< uint64_t > sum_ns_{ 0 };
+	};
+
+	/// Copy of evaluator metrics at a point in time.
+	struct SPOT_API evaluator_metrics_snapshot
+	{
+		uint64_t evaluations = 0;
+		uint64_t errors = 0;
+		uint64_t cancelled = 0; // evaluations skipped after a stop request
+		uint64_t in_flight = 0; // evaluations that are queued or running
+		size_t workers = 0;
+		double wall_time = 0; // seconds since the metrics were reset
+		double busy_time = 0; // total wall time spent in evaluations
+		double cpu_time = 0; // total thread cpu time spent in evaluations
+		histogram_snapshot queue_wait;
+		histogram_snapshot execution;
+
+		/// Fraction of available worker time spent in evaluations.
+		double utilization() const { return wall_time > 0 && workers > 0 ? busy_time / ( wall_time * workers ) : 0.0; }
+		/// Ratio of cpu time to wall time during evaluations, low values indicate waiting.
+		double cpu_ratio() const { return busy_time > 0 ? cpu_time / busy_time : 0.0; }
+	};
+
+	/// Lock-free counters and histograms that describe the activity of an evaluator.
+	class SPOT_API evaluator_metrics
+	{
+	public:
+		using clock = std::chrono::steady_clock;
+
+		/// Timestamps of a single evaluation task.
+		struct task {
+			clock::time_point queued;
+			clock::time_point started;
+			double cpu_started = 0;
+		};
+
+		evaluator_metrics();
+
+		task queue_task();
+		void start_task( task& t );
+		/// Returns the execution time in seconds.
+		double finish_task( const task& t, bool error );
+		/// Task is completed without being evaluated.
+		void cancel_task( const task& t );
+
+		void set_workers( size_t workers ) { workers_.store( workers, std::memory_order_relaxed ); }
+		evaluator_metrics_snapshot snapshot() const;
+		void reset();
+
+	private:
+		std::atomic< uint64_t > evaluations_;
+		std::atomic< uint64_t > errors_;
+		std::atomic< uint64_t > cancelled_;
+		std::atomic< uint64_t > in_flight_;
+		std::atomic< size_t > workers_;
+		std::atomic< uint64_t > busy_ns_;
+		std::atomic< uint64_t > cpu_ns_;
+		std::atomic< clock::rep > reset_time_;
+		latency_histogram queue_wait_;
+		latency_histogram execution_;
+	};
+}
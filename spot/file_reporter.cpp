@@ -24,8 +24,27 @@ namespace spot
 	{
 		xo::create_directories( root_ );
 
+		if ( output_population_log_ )
+			population_log_.open( root_ / "population.bin", opt.obj().info() );
+
+		// setup history.bin
+		if ( output_fitness_history_ && binary_history_ )
+		{
+			vector< string > labels{ "generation", "best_fitness", "median_fitness" };
+			if ( opt.fitness_tracking_window_size() > 0 )
+				labels.insert( labels.end(), { "predicted_fitness", "fitness_progress" } );
+			if ( output_par_history_ )
+			{
+				for ( auto& pi : opt.obj().info() )
+					labels.push_back( pi.name );
+				for ( auto& l : opt.optimizer_state_labels() )
+					labels.push_back( l );
+			}
+			binary_history_writer_.open( root_ / "history.bin", labels );
+			history_row_.reserve( labels.size() );
+		}
 		// setup history.txt
-		if ( output_fitness_history_ )
+		else if ( output_fitness_history_ )
 		{
 			history_ = std::ofstream( ( root_ / "history.txt" ).str() );
 			history_ << "generation\tbest_fitness\tmedian_fitness";
@@ -47,7 +66,11 @@ namespace spot
 
 	void file_reporter::on_stop( const optimizer& opt, const stop_condition& s )
 	{
-		if ( output_fitness_history_ )
+		if ( population_log_.is_open() )
+			population_log_.flush();
+		if ( binary_history_writer_.is_open() )
+			binary_history_writer_.flush();
+		else if ( output_fitness_history_ )
 			history_.flush();
 	}
 
@@ -65,6 +88,9 @@ namespace spot
 
 	void file_reporter::on_post_evaluate_population( const optimizer& opt, const search_point_vec& pop, const fitness_vec& fitnesses, bool new_best )
 	{
+		if ( population_log_.is_open() && !pop.empty() )
+			population_log_.write( opt.current_step(), pop, fitnesses, opt.current_step_evaluation_durations() );
+
 		if ( opt.current_step() - last_output_step >= max_steps_without_file_output_ )
 			write_par_file( opt, false );
 	}
@@ -76,7 +102,24 @@ namespace spot
 
 	void file_reporter::on_post_step( const optimizer& opt )
 	{
-		if ( output_fitness_history_ )
+		if ( binary_history_writer_.is_open() )
+		{
+			history_row_.clear();
+			history_row_.insert( history_row_.end(), { double( opt.current_step() ), opt.current_step_best_fitness(), xo::median( opt.current_step_fitnesses() ) } );
+			if ( opt.fitness_tracking_window_size() > 0 )
+				history_row_.insert( history_row_.end(), { opt.predicted_fitness( opt.fitness_tracking_window_size() ), opt.progress() } );
+			if ( output_par_history_ )
+			{
+				for ( auto&& v : opt.current_step_best_point().values() )
+					history_row_.push_back( v );
+				for ( auto&& v : opt.optimizer_state_values() )
+					history_row_.push_back( v );
+			}
+			binary_history_writer_.write_row( history_row_ );
+			if ( opt.current_step() % 10 == 9 ) // flush every 10 entries
+				binary_history_writer_.flush();
+		}
+		else if ( output_fitness_history_ )
 		{
 			// update history
 			auto cur_trend = opt.fitness_trend();
@@ -2,6 +2,8 @@
 
 #include "xo/container/circular_deque.h"
 #include "reporter.h"
+#include "binary_history.h"
+#include "population_log.h"
 #include <fstream>
 
 namespace spot
@@ -22,6 +24,8 @@ namespace spot
 		bool output_fitness_history_ = true;
 		bool output_par_history_ = false;
 		bool output_individual_search_points = false;
+		bool binary_history_ = false; // write history.bin instead of history.txt
+		bool output_population_log_ = false; // write all individuals to population.bin
 
 	private:
 		void write_par_file( const optimizer& opt, bool try_cleanup );
@@ -30,5 +34,8 @@ namespace spot
 		index_t last_output_step;
 		xo::circular_deque< pair< path, fitness_t > > recent_files;
 		std::ofstream history_;
+		binary_history_writer binary_history_writer_;
+		vector< double > history_row_;
+		population_log_writer population_log_;
 	};
 }
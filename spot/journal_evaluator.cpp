@@ -0,0 +1,209 @@
+#include "journal_evaluator.h"
+#include "binary_io.h"
+
+#include "objective.h"
+#include "xo/system/assert.h"
+#include "xo/system/log.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
+#ifdef _WIN32
+#	include <io.h>
+#else
+#	include <unistd.h>
+#endif
+
+namespace spot
+{
+	// header layout: magic, version, dim
+	// entry layout: fitness, duration, error length, error chars, point (dim)
+	static const char journal_magic[8] = { 'S', 'P', 'O', 'T', 'J', 'R', 'N', 'L' };
+	static const uint32_t journal_version = 1;
+
+	template< typename T > void append_binary( vector< char >& buf, const T& v ) {
+		auto* p = reinterpret_cast<const char*>( &v );
+		buf.insert( buf.end(), p, p + sizeof( T ) );
+	}
+
+	journal_evaluator::journal_evaluator( evaluator& eval, const path& filename, size_t sync_interval ) :
+		evaluator_( eval ),
+		filename_( filename ),
+		sync_interval_( sync_interval ),
+		evaluate_calls_( 0 ),
+		replay_pos_( 0 ),
+		recorded_evaluations_( 0 ),
+		dim_( 0 ),
+		valid_size_( 0 ),
+		file_( nullptr )
+	{
+		read_journal();
+	}
+
+	journal_evaluator::~journal_evaluator()
+	{
+		if ( file_ )
+		{
+			sync();
+			std::fclose( file_ );
+		}
+	}
+
+	vector< result<fitness_t> > journal_evaluator::evaluate( const objective& o, const search_point_vec& point_vec, const xo::stop_token& st, priority_t prio )
+	{
+		std::scoped_lock lock( mutex_ );
+		vector< result<fitness_t> > results( point_vec.size() );
+		vector< double > durations( point_vec.size(), std::numeric_limits< double >::quiet_NaN() );
+
+		// replay evaluations for as long as the points match the journal
+		index_t replay_count = 0;
+		for ( ; replay_count < point_vec.size() && is_replaying(); ++replay_count, ++replay_pos_ )
+		{
+			const auto& e = entries_[replay_pos_];
+			const auto& values = point_vec[replay_count].values();
+			if ( values.size() != e.point.size() || !std::equal( values.begin(), values.end(), e.point.begin() ) )
+			{
+				xo::log::warning( "Journal ", filename_.str(), " does not match evaluation ", replay_pos_, ", discarding ", entries_.size() - replay_pos_, " entries" );
+				entries_.resize( replay_pos_ );
+				break;
+			}
+			results[replay_count] = e.fitness;
+			valid_size_ = e.end_offset;
+			durations[replay_count] = e.duration;
+		}
+
+		// evaluate and record the remaining points
+		if ( replay_count < point_vec.size() )
+		{
+			entries_.clear(); // replay has finished
+			search_point_vec live_points( point_vec.begin() + replay_count, point_vec.end() );
+			auto& thread_durations = thread_evaluation_durations();
+			thread_durations.clear();
+			auto live_results = evaluator_.evaluate( o, live_points, st, prio );
+			bool has_durations = thread_durations.size() == live_points.size();
+
+			for ( index_t i = 0; i < live_points.size(); ++i )
+			{
+				auto idx = replay_count + i;
+				results[idx] = std::move( live_results[i] );
+				if ( has_durations )
+					durations[idx] = thread_durations[i];
+			}
+
+			// evaluations that were interrupted or cancelled are not recorded
+			if ( !st.stop_requested() )
+			{
+				if ( !file_ )
+					open_journal( live_points.front().size() );
+				for ( index_t i = 0; i < live_points.size(); ++i )
+					write_entry( live_points[i], results[replay_count + i], durations[replay_count + i] );
+				recorded_evaluations_ += live_points.size();
+			}
+
+			if ( sync_interval_ > 0 && ++evaluate_calls_ % sync_interval_ == 0 )
+				sync();
+		}
+
+		thread_evaluation_durations() = durations;
+		return results;
+	}
+
+	void journal_evaluator::sync()
+	{
+		if ( file_ )
+		{
+			// sync is also called from the destructor, so failures are logged instead of thrown
+			if ( std::fflush( file_ ) != 0 )
+				xo::log::error( "Could not write to journal ", filename_.str() );
+#ifdef _WIN32
+			else if ( _commit( _fileno( file_ ) ) != 0 )
+#else
+			else if ( fsync( fileno( file_ ) ) != 0 )
+#endif
+				xo::log::error( "Could not sync journal ", filename_.str() );
+		}
+	}
+
+	void journal_evaluator::read_journal()
+	{
+		std::ifstream str( filename_.str(), std::ios::binary );
+		if ( !str.good() )
+			return; // new journal
+
+		char magic[sizeof( journal_magic )];
+		str.read( magic, sizeof( magic ) );
+		if ( !str )
+			return; // journal without header is rewritten
+		xo_error_if( std::memcmp( magic, journal_magic, sizeof( magic ) ) != 0, filename_.str() + " is not an evaluation journal" );
+		auto version = read_binary< uint32_t >( str );
+		xo_error_if( version != journal_version, "Unsupported journal version in " + filename_.str() );
+		dim_ = read_binary< uint32_t >( str );
+		if ( !str )
+			return;
+
+		// read all complete entries, an incomplete entry at the end is discarded
+		while ( true )
+		{
+			entry e;
+			auto fitness = read_binary< double >( str );
+			e.duration = read_binary< double >( str );
+			string error( read_binary< uint32_t >( str ), '\0' );
+			str.read( error.data(), error.size() );
+			vector< double > point( dim_ );
+			str.read( reinterpret_cast<char*>( point.data() ), point.size() * sizeof( double ) );
+			if ( !str )
+				break;
+			e.end_offset = str.tellg();
+			e.point.assign( point.begin(), point.end() );
+			if ( error.empty() )
+				e.fitness = fitness_t( fitness );
+			else e.fitness = xo::error_message( error );
+			entries_.emplace_back( std::move( e ) );
+		}
+		if ( !entries_.empty() )
+			xo::log::info( "Replaying ", entries_.size(), " evaluations from ", filename_.str() );
+	}
+
+	void journal_evaluator::open_journal( size_t dim )
+	{
+		// remove entries that were not replayed, the header is rewritten if nothing was replayed
+		std::error_code ec;
+		if ( std::filesystem::exists( filename_.str(), ec ) )
+			std::filesystem::resize_file( filename_.str(), uintmax_t( valid_size_ ), ec );
+		xo_error_if( ec, "Could not truncate journal " + filename_.str() + ": " + ec.message() );
+
+		file_ = std::fopen( filename_.str().c_str(), "ab" );
+		xo_error_if( !file_, "Could not open journal " + filename_.str() );
+		if ( valid_size_ == 0 )
+		{
+			dim_ = dim;
+			buffer_.clear();
+			buffer_.insert( buffer_.end(), journal_magic, journal_magic + sizeof( journal_magic ) );
+			append_binary( buffer_, journal_version );
+			append_binary( buffer_, uint32_t( dim_ ) );
+			write_buffer();
+		}
+	}
+
+	void journal_evaluator::write_entry( const search_point& point, const result< fitness_t >& fitness, double duration )
+	{
+		xo_error_if( point.size() != dim_, "Journal " + filename_.str() + " has a different number of parameters" );
+		const auto& error = fitness.error().message();
+		buffer_.clear();
+		append_binary( buffer_, double( fitness ? fitness.value() : 0 ) );
+		append_binary( buffer_, duration );
+		append_binary( buffer_, uint32_t( fitness ? 0 : error.size() ) );
+		if ( !fitness )
+			buffer_.insert( buffer_.end(), error.begin(), error.end() );
+		for ( auto v : point.values() )
+			append_binary( buffer_, double( v ) );
+		write_buffer();
+	}
+
+	void journal_evaluator::write_buffer()
+	{
+		auto written = std::fwrite( buffer_.data(), 1, buffer_.size(), file_ );
+		xo_error_if( written != buffer_.size(), "Could not write to journal " + filename_.str() );
+	}
+}
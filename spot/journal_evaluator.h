@@ -0,0 +1,56 @@
+#pragma once
+
+#include "spot_types.h"
+#include "evaluator.h"
+#include "xo/filesystem/path.h"
+#include <cstdio>
+#include <mutex>
+
+namespace spot
+{
+	/// Evaluator that appends each evaluation (point, fitness or error, duration) to a binary journal.
+	/// If the journal already exists, its evaluations are replayed instead of evaluated, for as long
+	/// as the requested points match the journal. With a fixed random seed, this restores the exact
+	/// state of an interrupted optimization. A journal should be used by a single optimizer.
+	class SPOT_API journal_evaluator : public evaluator
+	{
+	public:
+		/// Journal is synced to disk every sync_interval calls to evaluate(), 0 only syncs on destruction.
+		journal_evaluator( evaluator& eval, const path& filename, size_t sync_interval = 1 );
+		virtual ~journal_evaluator();
+
+		virtual vector< result<fitness_t> > evaluate( const objective& o, const search_point_vec& point_vec, const xo::stop_token& st, priority_t prio = 0 ) override;
+
+		size_t replayed_evaluations() const { return replay_pos_; }
+		size_t journal_evaluations() const { return replay_pos_ + recorded_evaluations_; }
+		bool is_replaying() const { return replay_pos_ < entries_.size(); }
+		void sync();
+
+	private:
+		struct entry {
+			par_vec point;
+			result< fitness_t > fitness;
+			double duration;
+			long long end_offset;
+		};
+
+		void read_journal();
+		void open_journal( size_t dim );
+		void write_entry( const search_point& point, const result< fitness_t >& fitness, double duration );
+		void write_buffer();
+
+		evaluator& evaluator_;
+		path filename_;
+		size_t sync_interval_;
+		size_t evaluate_calls_;
+
+		std::mutex mutex_;
+		vector< entry > entries_;
+		size_t replay_pos_;
+		size_t recorded_evaluations_;
+		size_t dim_;
+		long long valid_size_; // size of the journal up to the last replayed entry
+		std::FILE* file_;
+		vector< char > buffer_;
+	};
+}
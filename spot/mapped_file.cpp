@@ -0,0 +1,104 @@
+#include "mapped_file.h"
+
+#include "xo/system/assert.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+#	define NOMINMAX
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+namespace spot
+{
+	mapped_file::mapped_file( const path& filename ) :
+		filename_( filename ),
+		data_( nullptr ),
+		size_( 0 )
+	{
+#ifdef _WIN32
+		file_handle_ = CreateFileA( filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+		xo_error_if( file_handle_ == INVALID_HANDLE_VALUE, "Could not open " + filename.str() );
+		LARGE_INTEGER size;
+		GetFileSizeEx( file_handle_, &size );
+		size_ = size_t( size.QuadPart );
+		mapping_handle_ = size_ > 0 ? CreateFileMappingA( file_handle_, NULL, PAGE_READONLY, 0, 0, NULL ) : NULL;
+		if ( mapping_handle_ )
+			data_ = static_cast<const char*>( MapViewOfFile( mapping_handle_, FILE_MAP_READ, 0, 0, 0 ) );
+		if ( size_ > 0 && !data_ )
+		{
+			if ( mapping_handle_ ) CloseHandle( mapping_handle_ );
+			CloseHandle( file_handle_ );
+			xo_error( "Could not map " + filename.str() );
+		}
+#else
+		int fd = ::open( filename.c_str(), O_RDONLY );
+		xo_error_if( fd < 0, "Could not open " + filename.str() + ": " + std::strerror( errno ) );
+		struct stat st;
+		if ( fstat( fd, &st ) == 0 && st.st_size > 0 )
+		{
+			size_ = size_t( st.st_size );
+			void* p = mmap( nullptr, size_, PROT_READ, MAP_SHARED, fd, 0 );
+			if ( p == MAP_FAILED )
+			{
+				auto err = errno;
+				::close( fd );
+				xo_error( "Could not map " + filename.str() + ": " + std::strerror( err ) );
+			}
+			data_ = static_cast<const char*>( p );
+		}
+		::close( fd ); // the mapping keeps the file open
+#endif
+	}
+
+	mapped_file::~mapped_file()
+	{
+#ifdef _WIN32
+		if ( data_ ) UnmapViewOfFile( data_ );
+		if ( mapping_handle_ ) CloseHandle( mapping_handle_ );
+		CloseHandle( file_handle_ );
+#else
+		if ( data_ ) munmap( const_cast<char*>( data_ ), size_ );
+#endif
+	}
+
+#ifndef _WIN32
+	// madvise requires a page aligned address
+	static void advise_range( const char* data, size_t file_size, size_t offset, size_t size, int advice )
+	{
+		if ( !data || offset >= file_size )
+			return;
+		const auto page = size_t( sysconf( _SC_PAGESIZE ) );
+		const auto begin = offset / page * page;
+		const auto end = std::min( offset + size, file_size );
+		madvise( const_cast<char*>( data ) + begin, end - begin, advice );
+	}
+#endif
+
+	void mapped_file::will_need( size_t offset, size_t size ) const
+	{
+#ifdef _WIN32
+		if ( !data_ || offset >= size_ )
+			return;
+		WIN32_MEMORY_RANGE_ENTRY range{ const_cast<char*>( data_ ) + offset, std::min( size, size_ - offset ) };
+		PrefetchVirtualMemory( GetCurrentProcess(), 1, &range, 0 );
+#else
+		advise_range( data_, size_, offset, size, MADV_WILLNEED );
+#endif
+	}
+
+	void mapped_file::dont_need( size_t offset, size_t size ) const
+	{
+#ifdef _WIN32
+		// clean pages of read-only mappings are trimmed from the working set by the system
+#else
+		advise_range( data_, size_, offset, size, MADV_DONTNEED );
+#endif
+	}
+}
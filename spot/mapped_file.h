@@ -0,0 +1,35 @@
+#pragma once
+
+#include "spot_types.h"
+
+namespace spot
+{
+	/// Read-only memory mapping of a file.
+	/// Pages are loaded on demand and shared with all other threads and processes that map the same file,
+	/// so files larger than physical memory can be mapped.
+	class SPOT_API mapped_file
+	{
+	public:
+		mapped_file( const path& filename );
+		~mapped_file();
+		mapped_file( const mapped_file& ) = delete;
+		mapped_file& operator=( const mapped_file& ) = delete;
+
+		const char* data() const { return data_; }
+		size_t size() const { return size_; }
+		const path& filename() const { return filename_; }
+
+		/// Hint that a range will be accessed soon, or that its pages can be dropped from memory.
+		void will_need( size_t offset, size_t size ) const;
+		void dont_need( size_t offset, size_t size ) const;
+
+	private:
+		path filename_;
+		const char* data_;
+		size_t size_;
+#ifdef _WIN32
+		void* file_handle_;
+		void* mapping_handle_;
+#endif
+	};
+}
@@ -78,6 +78,7 @@ namespace spot
 	void mes_optimizer::sample_population()
 	{
 		XO_PROFILE_FUNCTION( profiler_ );
+		SPOT_TRACE_SCOPE( "mes_optimizer::sample_population" );
 
 		auto mom_dist = std::normal_distribution( options_.mom_offset, options_.mom_offset_stdev );
 		const auto n = info().dim();
@@ -97,6 +98,7 @@ namespace spot
 	void mes_optimizer::update_distribution()
 	{
 		XO_PROFILE_FUNCTION( profiler_ );
+		SPOT_TRACE_SCOPE( "mes_optimizer::update_distribution" );
 
 		const auto n = info().dim();
 		auto order = xo::sorted_indices( current_step_fitnesses_, [&]( auto a, auto b ) { return info().is_better( a, b ); } );
@@ -0,0 +1,33 @@
+#include "metrics_reporter.h"
+
+#include "optimizer.h"
+#include "xo/system/log.h"
+#include "xo/string/string_tools.h"
+
+namespace spot
+{
+	metrics_reporter::metrics_reporter( const evaluator& e, size_t interval ) :
+		evaluator_( e ),
+		interval_( std::max< size_t >( 1, interval ) )
+	{}
+
+	void metrics_reporter::on_post_step( const optimizer& opt )
+	{
+		if ( ( opt.current_step() + 1 ) % interval_ == 0 )
+			xo::log::info( opt.name, " ", format( evaluator_.metrics().snapshot() ) );
+	}
+
+	void metrics_reporter::on_stop( const optimizer& opt, const stop_condition& s )
+	{
+		xo::log::info( opt.name, " ", format( evaluator_.metrics().snapshot() ) );
+	}
+
+	string metrics_reporter::format( const evaluator_metrics_snapshot& m )
+	{
+		return xo::stringf( "evaluations=%llu errors=%llu cancelled=%llu in_flight=%llu workers=%zu utilization=%.1f%% cpu=%.1f%% wait_p50=%.3gs wait_p99=%.3gs exec_p50=%.3gs exec_p99=%.3gs",
+			(unsigned long long)m.evaluations, (unsigned long long)m.errors, (unsigned long long)m.cancelled, (unsigned long long)m.in_flight, m.workers,
+			100 * m.utilization(), 100 * m.cpu_ratio(),
+			m.queue_wait.percentile( 0.5 ), m.queue_wait.percentile( 0.99 ),
+			m.execution.percentile( 0.5 ), m.execution.percentile( 0.99 ) );
+	}
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "reporter.h"
+#include "evaluator.h"
+
+namespace spot
+{
+	/// Periodically logs a summary of the metrics of an evaluator.
+	struct SPOT_API metrics_reporter : public reporter
+	{
+		metrics_reporter( const evaluator& e, size_t interval = 10 );
+
+		virtual void on_post_step( const optimizer& opt ) override;
+		virtual void on_stop( const optimizer& opt, const stop_condition& s ) override;
+
+		static string format( const evaluator_metrics_snapshot& m );
+
+	private:
+		const evaluator& evaluator_;
+		size_t interval_;
+	};
+}
@@ -0,0 +1,40 @@
+#include "minibatch_objective.h"
+
+#include <algorithm>
+#include <random>
+#include <unordered_set>
+
+namespace spot
+{
+	bool minibatch_objective::bind_optimizer( const optimizer& opt )
+	{
+		const optimizer* expected = nullptr;
+		return optimizer_.compare_exchange_strong( expected, &opt ) || expected == &opt;
+	}
+
+	void minibatch_objective::release_optimizer( const optimizer& opt )
+	{
+		const optimizer* expected = &opt;
+		optimizer_.compare_exchange_strong( expected, nullptr );
+	}
+
+	vector< size_t > select_minibatch_blocks( size_t blocks, size_t count, uint64_t seed )
+	{
+		count = std::min( count, blocks );
+		std::mt19937_64 rng( seed );
+
+		// Floyd's algorithm, uses O(count) memory regardless of the number of blocks
+		std::unordered_set< size_t > selected;
+		selected.reserve( count );
+		for ( size_t j = blocks - count; j < blocks; ++j )
+		{
+			auto t = std::uniform_int_distribution< size_t >( 0, j )( rng );
+			if ( !selected.insert( t ).second )
+				selected.insert( j );
+		}
+
+		vector< size_t > result( selected.begin(), selected.end() );
+		std::sort( result.begin(), result.end() );
+		return result;
+	}
+}
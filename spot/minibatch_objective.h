@@ -0,0 +1,43 @@
+#pragma once
+
+#include "spot_types.h"
+#include <atomic>
+#include <cstdint>
+
+namespace spot
+{
+	/// Objective that can be evaluated on a random subset of its samples, see minibatch_reporter.
+	/// The subset changes only through set_minibatch(), so that all points of a population can be
+	/// evaluated on the same subset. It must not be changed while evaluations are in progress.
+	/// Because the subset is shared, only a single optimizer can use it at a time, see bind_optimizer().
+	class SPOT_API minibatch_objective
+	{
+	public:
+		minibatch_objective() = default;
+		minibatch_objective( const minibatch_objective& ) : optimizer_( nullptr ) {}
+		minibatch_objective& operator=( const minibatch_objective& ) { return *this; }
+		virtual ~minibatch_objective() = default;
+
+		/// Register the optimizer that selects the subsets, returns false if another optimizer is registered.
+		bool bind_optimizer( const optimizer& opt );
+		void release_optimizer( const optimizer& opt );
+		const optimizer* bound_optimizer() const { return optimizer_; }
+
+		/// Evaluate on a random subset of at least samples, or on all samples if samples >= sample_count().
+		virtual void set_minibatch( size_t samples, uint64_t seed ) = 0;
+		virtual void set_full_batch() = 0;
+
+		/// Number of samples used per evaluation.
+		virtual size_t minibatch_size() const = 0;
+		virtual size_t sample_count() const = 0;
+
+		/// Total number of samples evaluated.
+		virtual size_t sample_evaluations() const = 0;
+
+	private:
+		std::atomic< const optimizer* > optimizer_ = nullptr;
+	};
+
+	/// Select count distinct blocks from [0, blocks) in ascending order.
+	SPOT_API vector< size_t > select_minibatch_blocks( size_t blocks, size_t count, uint64_t seed );
+}
@@ -0,0 +1,110 @@
+#include "minibatch_reporter.h"
+
+#include "optimizer_pool.h"
+#include "xo/system/log.h"
+#include <cmath>
+
+namespace spot
+{
+	minibatch_reporter::minibatch_reporter( minibatch_objective& o, const minibatch_options& options ) :
+		objective_( o ),
+		optimizer_( nullptr ),
+		options_( options ),
+		initial_spread_( 0 ),
+		stall_factor_( 1 ),
+		last_stall_step_( 0 ),
+		confirmed_fitness_( 0 )
+	{}
+
+	minibatch_reporter::~minibatch_reporter()
+	{
+		if ( optimizer_ )
+			objective_.release_optimizer( *optimizer_ );
+	}
+
+	void minibatch_reporter::on_start( const optimizer& opt )
+	{
+		// the members of a pool share their objective, but each would select a different subset
+		if ( dynamic_cast<const optimizer_pool*>( &opt ) )
+			xo::log::error( "minibatch_reporter cannot be used with optimizer_pool" );
+		else if ( !objective_.bind_optimizer( opt ) )
+			xo::log::error( opt.name, ": minibatch objective is already used by another optimizer, minibatches are disabled" );
+		else optimizer_ = &opt;
+	}
+
+	void minibatch_reporter::on_pre_evaluate_population( const optimizer& opt, const search_point_vec& pop )
+	{
+		if ( &opt != optimizer_ )
+			return;
+
+		auto spread = population_spread( pop );
+		if ( initial_spread_ <= 0 )
+			initial_spread_ = spread;
+
+		auto size = double( options_.initial_size ) * stall_factor_;
+		if ( spread > 0 && initial_spread_ > 0 )
+			size *= std::pow( std::max( 1.0, initial_spread_ / spread ), options_.spread_exponent );
+		else if ( initial_spread_ > 0 )
+			size = double( objective_.sample_count() ); // population has collapsed
+
+		// same seed for all individuals of a generation, different seeds between generations
+		auto samples = size_t( std::min( size, double( objective_.sample_count() ) ) );
+		objective_.set_minibatch( samples, options_.random_seed + opt.current_step() );
+	}
+
+	void minibatch_reporter::on_post_step( const optimizer& opt )
+	{
+		if ( &opt != optimizer_ || opt.fitness_tracking_window_size() == 0 || objective_.minibatch_size() >= objective_.sample_count() )
+			return;
+		if ( opt.current_step() >= last_stall_step_ + options_.stall_window && opt.progress() < options_.stall_progress )
+		{
+			stall_factor_ *= options_.stall_growth;
+			last_stall_step_ = opt.current_step();
+		}
+	}
+
+	void minibatch_reporter::on_stop( const optimizer& opt, const stop_condition& s )
+	{
+		if ( &opt != optimizer_ )
+			return;
+
+		// minibatch fitnesses are optimistic for the best points, confirm using all samples
+		objective_.set_full_batch();
+		confirmed_point_.reset();
+		for ( const auto* sp : { &opt.best_point(), &opt.current_step_best_point() } )
+		{
+			auto r = opt.obj().evaluate( *sp, xo::stop_token() );
+			if ( r && ( !confirmed_point_ || opt.is_better( r.value(), confirmed_fitness_ ) ) )
+			{
+				confirmed_point_ = *sp;
+				confirmed_fitness_ = r.value();
+			}
+		}
+		if ( confirmed_point_ )
+			xo::log::info( opt.name, " confirmed fitness=", confirmed_fitness_, " samples=", objective_.sample_evaluations() );
+		objective_.release_optimizer( opt );
+		optimizer_ = nullptr;
+	}
+
+	double minibatch_reporter::population_spread( const search_point_vec& pop )
+	{
+		if ( pop.size() < 2 )
+			return 0;
+
+		// mean of the standard deviations of all parameters
+		const auto dim = pop.front().size();
+		double spread = 0;
+		for ( index_t i = 0; i < dim; ++i )
+		{
+			double sum = 0, sum_sq = 0;
+			for ( const auto& sp : pop )
+			{
+				sum += sp[i];
+				sum_sq += sp[i] * sp[i];
+			}
+			auto mean = sum / pop.size();
+			spread += std::sqrt( std::max( 0.0, sum_sq / pop.size() - mean * mean ) );
+		}
+		return spread / dim;
+	}
+}
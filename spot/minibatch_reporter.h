@@ -0,0 +1,54 @@
+#pragma once
+
+#include "reporter.h"
+#include "minibatch_objective.h"
+#include <optional>
+
+namespace spot
+{
+	struct minibatch_options
+	{
+		size_t initial_size = 1000; // number of samples in the first generation
+		double spread_exponent = 1.0; // batch size grows with ( initial spread / current spread ) ^ spread_exponent
+		double stall_progress = 1e-4; // batch size is multiplied by stall_growth when progress drops below this value
+		double stall_growth = 2.0;
+		size_t stall_window = 50; // minimum number of steps between stall adjustments
+		uint64_t random_seed = 123;
+	};
+
+	/// Evaluates each generation on a new random subset of the samples of a minibatch_objective.
+	/// All individuals of a generation use the same subset, so that they can be ranked fairly.
+	/// The subset grows when the spread of the population shrinks, or when progress stalls
+	/// (this requires fitness tracking, e.g. through min_progress_condition, and a stall_progress
+	/// that is larger than the minimum progress). After the optimization stops, the best points
+	/// are re-evaluated on all samples, see confirmed_point() and confirmed_fitness().
+	/// Each optimizer needs its own objective, which means minibatch_reporter cannot be used with optimizer_pool.
+	/// If the objective is already used by another optimizer, an error is logged and the reporter does nothing.
+	class SPOT_API minibatch_reporter : public reporter
+	{
+	public:
+		minibatch_reporter( minibatch_objective& o, const minibatch_options& options = minibatch_options() );
+		virtual ~minibatch_reporter();
+
+		virtual void on_start( const optimizer& opt ) override;
+		virtual void on_pre_evaluate_population( const optimizer& opt, const search_point_vec& pop ) override;
+		virtual void on_post_step( const optimizer& opt ) override;
+		virtual void on_stop( const optimizer& opt, const stop_condition& s ) override;
+
+		double stall_factor() const { return stall_factor_; }
+		const search_point* confirmed_point() const { return confirmed_point_ ? &*confirmed_point_ : nullptr; }
+		fitness_t confirmed_fitness() const { return confirmed_fitness_; }
+
+	private:
+		static double population_spread( const search_point_vec& pop );
+
+		minibatch_objective& objective_;
+		const optimizer* optimizer_;
+		minibatch_options options_;
+		double initial_spread_;
+		double stall_factor_;
+		index_t last_stall_step_;
+		std::optional< search_point > confirmed_point_;
+		fitness_t confirmed_fitness_;
+	};
+}
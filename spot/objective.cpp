@@ -1,6 +1,7 @@
 #include "objective.h"
 
 #include <future>
+#include <atomic>
 
 #include "xo/system/system_tools.h"
 #include "xo/system/log.h"
@@ -11,7 +12,9 @@ namespace spot
 	{
 		try
 		{
-			return evaluate( point, st );
+			// no persistent context available, create a temporary one
+			auto context = create_context();
+			return evaluate( point, st, context.get() );
 		}
 		catch ( std::exception& e )
 		{
@@ -22,4 +25,38 @@ namespace spot
 			return xo::error_message( "Unknown exception while evaluating objective" );
 		}
 	}
+
+	result<fitness_t> objective::evaluate_noexcept( const search_point& point, const xo::stop_token& st, objective_context* context ) const noexcept
+	{
+		try
+		{
+			return evaluate( point, st, context );
+		}
+		catch ( std::exception& e )
+		{
+			return xo::error_message( e.what() );
+		}
+		catch ( ... )
+		{
+			return xo::error_message( "Unknown exception while evaluating objective" );
+		}
+	}
+
+	size_t objective::next_id()
+	{
+		static std::atomic< size_t > s_next_id = 0;
+		return s_next_id++;
+	}
+
+	objective_context* objective_context_cache::get( const objective& o )
+	{
+		for ( auto& [id, context] : contexts_ )
+			if ( id == o.id() )
+				return context.get();
+
+		// first evaluation of this objective in this worker
+		if ( contexts_.size() >= max_size_ )
+			contexts_.erase( contexts_.begin() );
+		return contexts_.emplace_back( o.id(), o.create_context() ).second.get();
+	}
 }
@@ -7,26 +7,57 @@
 
 namespace spot
 {
+	/// Mutable evaluation state, created once per evaluator worker through objective::create_context().
+	struct SPOT_API objective_context
+	{
+		virtual ~objective_context() = default;
+	};
+
 	class SPOT_API objective
 	{
 	public:
-		objective() = default;
-		objective( objective_info info ) : info_( std::move( info ) ) {}
+		objective() : id_( next_id() ) {}
+		objective( objective_info info ) : info_( std::move( info ) ), id_( next_id() ) {}
+		objective( const objective& o ) : info_( o.info_ ), id_( next_id() ) {}
+		objective& operator=( const objective& o ) { info_ = o.info_; id_ = next_id(); return *this; }
 
 		virtual ~objective() = default;
 
 		const objective_info& info() const { return info_; }
 		objective_info& info() { return info_; }
 		size_t dim() const { return info_.dim(); }
+		size_t id() const { return id_; }
 
 		virtual string name() const { return info_.name(); }
 		virtual prop_node to_prop_node() const { return prop_node(); }
 
+		/// Override to reuse expensive setup across evaluations; return nullptr if no context is needed.
+		virtual u_ptr<objective_context> create_context() const { return nullptr; }
+
+		virtual result<fitness_t> evaluate( const search_point& point, const xo::stop_token& st, objective_context* context ) const { return evaluate( point, st ); }
 		virtual result<fitness_t> evaluate( const search_point& point, const xo::stop_token& ) const { return evaluate( point ); }
 		result<fitness_t> evaluate_noexcept( const search_point& point, const xo::stop_token& st ) const noexcept;
+		result<fitness_t> evaluate_noexcept( const search_point& point, const xo::stop_token& st, objective_context* context ) const noexcept;
 
 	protected:
 		virtual fitness_t evaluate( const search_point& point ) const { xo_error( "Implement either objective::evaluate(search_point,stop_token) or objective::evaluate(search_point)" ); }
 		objective_info info_;
+
+	private:
+		static size_t next_id();
+		size_t id_;
+	};
+
+	/// Contexts of recently used objectives, owned by a single evaluator worker.
+	class SPOT_API objective_context_cache
+	{
+	public:
+		objective_context_cache( size_t max_size = 8 ) : max_size_( max_size ) {}
+		objective_context* get( const objective& o );
+		void clear() { contexts_.clear(); }
+
+	private:
+		size_t max_size_;
+		vector< pair< size_t, u_ptr<objective_context> > > contexts_;
 	};
 }
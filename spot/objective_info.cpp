@@ -1,7 +1,9 @@
 #include "objective_info.h"
+#include "simd_dispatch.h"
 
 #include "xo/container/container_tools.h"
 #include "xo/system/assert.h"
+#include <cmath>
 #include <fstream>
 #include "xo/filesystem/filesystem.h"
 #include "xo/system/log.h"
@@ -47,6 +49,10 @@ namespace spot
 		}
 		else {
 			par_infos_.emplace_back( pi );
+			means_.push_back( pi.mean );
+			stds_.push_back( pi.std );
+			lower_bounds_.push_back( pi.min );
+			upper_bounds_.push_back( pi.max );
 			return par_infos_.back().mean;
 		}
 	}
@@ -102,6 +108,7 @@ namespace spot
 			}
 		}
 
+		update_arrays();
 		return { params_set, params_not_found };
 	}
 
@@ -135,7 +142,8 @@ namespace spot
 	void objective_info::set_std_minimum( par_t value, par_t factor )
 	{
 		for ( auto& p : par_infos_ )
-			p.std = xo::max( p.std, factor * fabs( p.mean ) + value );
+			p.std = xo::max( p.std, factor * std::abs( p.mean ) + value );
+		update_arrays();
 	}
 
 	void objective_info::set_mean_std( const par_vec& mean, const par_vec& std )
@@ -146,18 +154,20 @@ namespace spot
 			par_infos_[i].mean = mean[i];
 			par_infos_[i].std = std[i];
 		}
+		means_ = mean;
+		stds_ = std;
 	}
 
 	bool objective_info::is_feasible( const par_vec& vec ) const
 	{
-		for ( index_t i = 0; i < size(); ++i )
-			if ( vec[i] > par_infos_[i].max || vec[i] < par_infos_[i].min )
-				return false;
-		return true;
+		xo_assert( vec.size() >= size() );
+		return simd().count_out_of_bounds( size(), vec.data(), lower_bounds_.data(), upper_bounds_.data() ) == 0;
 	}
 
 	void objective_info::clamp( par_vec& vec ) const
 	{
+		if ( is_feasible( vec ) )
+			return;
 		for ( index_t i = 0; i < size(); ++i )
 		{
 			auto& pi = par_infos_[i];
@@ -170,6 +180,38 @@ namespace spot
 		}
 	}
 
+	size_t objective_info::is_feasible_batch( const par_t* points, size_t count, bool* feasible ) const
+	{
+		size_t feasible_count = 0;
+		for ( size_t k = 0; k < count; ++k, points += size() )
+		{
+			feasible[k] = simd().count_out_of_bounds( size(), points, lower_bounds_.data(), upper_bounds_.data() ) == 0;
+			feasible_count += feasible[k];
+		}
+		return feasible_count;
+	}
+
+	size_t objective_info::clamp_batch( par_t* points, size_t count ) const
+	{
+		return simd().clamp( size(), count, points, lower_bounds_.data(), upper_bounds_.data() );
+	}
+
+	void objective_info::update_arrays()
+	{
+		const auto n = par_infos_.size();
+		means_.resize( n );
+		stds_.resize( n );
+		lower_bounds_.resize( n );
+		upper_bounds_.resize( n );
+		for ( index_t i = 0; i < n; ++i )
+		{
+			means_[i] = par_infos_[i].mean;
+			stds_[i] = par_infos_[i].std;
+			lower_bounds_[i] = par_infos_[i].min;
+			upper_bounds_[i] = par_infos_[i].max;
+		}
+	}
+
 	vector< par_info >::const_iterator objective_info::find( const string& name ) const
 	{
 		return xo::find_if( par_infos_, [&]( const par_info& p ) { return p.name == name; } );
@@ -200,6 +242,7 @@ namespace spot
 			// convert parameter to locked
 			locked_pars_[iter->name] = value;
 			par_infos_.erase( iter ); // remove existing parameter
+			update_arrays();
 			return true;
 		}
 		else
@@ -17,7 +17,7 @@ namespace spot
 	{
 	public:
 		objective_info( bool min = true ) : minimize_( min ), target_fitness_( 0 ) {}
-		objective_info( vector<par_info> par_infos, bool min = true ) : par_infos_( std::move( par_infos ) ), minimize_( min ), target_fitness_( 0 ) {}
+		objective_info( vector<par_info> par_infos, bool min = true ) : par_infos_( std::move( par_infos ) ), minimize_( min ), target_fitness_( 0 ) { update_arrays(); }
 
 		virtual size_t dim() const override { return par_infos_.size(); }
 		virtual par_t add( const par_info& pi ) override;
@@ -53,6 +53,12 @@ namespace spot
 		size_t size() const { return par_infos_.size(); }
 		bool empty() const { return par_infos_.empty(); }
 
+		/// contiguous arrays of the parameter properties, kept consistent with the par_info entries
+		const par_vec& means() const { return means_; }
+		const par_vec& stds() const { return stds_; }
+		const par_vec& lower_bounds() const { return lower_bounds_; }
+		const par_vec& upper_bounds() const { return upper_bounds_; }
+
 		/// import / export
 		pair< size_t, size_t > import_mean_std( const path& filename, const par_import_settings& pis );
 		pair< size_t, size_t > import_locked( const path& filename, const xo::pattern_matcher& include = {}, const xo::pattern_matcher& exclude = {} );
@@ -64,13 +70,23 @@ namespace spot
 		bool is_feasible( const par_vec& vec ) const;
 		void clamp( par_vec& vec ) const;
 
+		/// check or clamp count points of dim() parameters, stored contiguously row by row
+		/// is_feasible_batch returns the number of feasible points, clamp_batch the number of clamped values
+		size_t is_feasible_batch( const par_t* points, size_t count, bool* feasible ) const;
+		size_t clamp_batch( par_t* points, size_t count ) const;
+
 	private:
 		vector< par_info > par_infos_;
 		xo::flat_map< string, par_t > locked_pars_;
 		bool minimize_;
 		fitness_t target_fitness_;
 		string name_;
+		par_vec means_;
+		par_vec stds_;
+		par_vec lower_bounds_;
+		par_vec upper_bounds_;
 
+		void update_arrays();
 		vector< par_info >::const_iterator find( const string& name ) const;
 		vector< par_info >::iterator find( const string& name );
 		const par_info* try_find( const string& name ) const;
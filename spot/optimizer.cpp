@@ -21,11 +21,13 @@ namespace spot
 		objective_( o ),
 		evaluator_( e ),
 		step_count_( 0 ),
+		evaluation_count_( 0 ),
 		best_fitness_( o.info().worst_fitness() ),
 		best_point_( o.info() ),
 		current_step_best_fitness_( o.info().worst_fitness() ),
 		current_step_best_point_( o.info() ),
 		fitness_history_samples_( 0 ),
+		fitness_trend_estimator_( trend_estimator::repeated_median ),
 		fitness_trend_step_( no_index ),
 		stop_condition_( nullptr ),
 		max_errors_( 0 )
@@ -44,6 +46,7 @@ namespace spot
 	const stop_condition* optimizer::step()
 	{
 		XO_PROFILE_FUNCTION( profiler_ );
+		SPOT_TRACE_SCOPE( "optimizer::step" );
 		xo_error_if( info().dim() <= 0, "Objective has no free parameters" );
 
 		// send out start callback if this is the first step
@@ -112,8 +115,11 @@ namespace spot
 	{
 		if ( fitness_trend_step_ != fitness_history_samples_ )
 		{
-			if ( fitness_history_.size() >= 2 )
+			if ( fitness_trend_estimator_ == trend_estimator::incremental )
+				fitness_trend_ = fitness_trend_tracker_.trend();
+			else if ( fitness_history_.size() >= 2 )
 			{
+				// reference implementation, O(n^2) in the window size
 				auto range = xo::make_irange< int >( int( fitness_history_samples_ - fitness_history_.size() ), int( fitness_history_samples_ ) );
 				//auto start = fitness_history_samples_ - fitness_history_.size();
 				fitness_trend_ = xo::repeated_median_regression( range.begin(), range.end(), fitness_history_.begin(), fitness_history_.end() );
@@ -157,7 +163,13 @@ namespace spot
 	vector< result<fitness_t> > optimizer::evaluate( const search_point_vec& point_vec, priority_t prio )
 	{
 		XO_PROFILE_FUNCTION( profiler_ );
-		return evaluator_.evaluate( objective_, point_vec, stop_source_.get_token(), prio );
+		SPOT_TRACE_SCOPE( "optimizer::evaluate" );
+		evaluation_count_ += point_vec.size();
+		auto& durations = evaluator::thread_evaluation_durations();
+		durations.clear();
+		auto results = evaluator_.evaluate( objective_, point_vec, stop_source_.get_token(), prio );
+		current_step_evaluation_durations_.assign( durations.begin(), durations.end() );
+		return results;
 	}
 
 	bool optimizer::evaluate_step( const search_point_vec& point_vec, priority_t prio )
@@ -168,6 +180,10 @@ namespace spot
 		// compute fitnesses
 		auto results = evaluate( point_vec );
 
+		// results of an interrupted step are incomplete, the step is discarded
+		if ( stop_requested() )
+			return false;
+
 		// stop if there were too many errors
 		if ( verify_results( results ) )
 		{
@@ -226,8 +242,11 @@ namespace spot
 		// update fitness history
 		if ( fitness_tracking_window_size() > 0 )
 		{
+			// NaN is tracked as the worst fitness, so that the trend stays aligned with the step count
+			auto f = std::isnan( current_step_best_fitness() ) ? info().worst_fitness() : current_step_best_fitness();
 			if ( fitness_history_.full() ) fitness_history_.pop_front();
-			fitness_history_.push_back( static_cast<float>( current_step_best_fitness() ) );
+			fitness_history_.push_back( static_cast<float>( f ) );
+			fitness_trend_tracker_.push_back( static_cast<float>( f ) );
 			++fitness_history_samples_;
 		}
 	}
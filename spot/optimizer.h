@@ -6,6 +6,7 @@
 #include "reporter.h"
 #include "evaluator.h"
 #include "stop_condition.h"
+#include "sliding_trend.h"
 
 #include "xo/container/circular_deque.h"
 #include "xo/container/prop_node.h"
@@ -19,9 +20,14 @@
 #include "xo/thread/stop_token.h"
 #include "xo/system/profiler.h"
 #include "xo/system/profiler_config.h"
+#include "tracer.h"
 
 namespace spot
 {
+	/// Method used to compute optimizer::fitness_trend(), repeated_median is the default.
+	/// incremental uses sliding_trend, which is O(log n) per step instead of O(n^2) for the window size n.
+	enum class trend_estimator { incremental, repeated_median };
+
 	class SPOT_API optimizer
 	{
 	public:
@@ -42,9 +48,11 @@ namespace spot
 
 		// optimization info
 		index_t current_step() const { return step_count_; }
+		size_t evaluation_count() const { return evaluation_count_; }
 		virtual const fitness_vec& current_step_fitnesses() const { return current_step_fitnesses_; }
 		virtual fitness_t current_step_best_fitness() const { return current_step_best_fitness_; }
 		virtual const search_point& current_step_best_point() const { return current_step_best_point_; }
+		const vector< double >& current_step_evaluation_durations() const { return current_step_evaluation_durations_; }
 		virtual fitness_t best_fitness() const { return best_fitness_; }
 		virtual const search_point& best_point() const { return best_point_; }
 
@@ -57,8 +65,10 @@ namespace spot
 		void set_boundary_transformer( u_ptr<boundary_transformer> bt ) { boundary_transformer_ = std::move( bt ); }
 
 		// fitness tracking and prediction
-		void set_fitness_tracking_window_size( size_t window_size ) { fitness_history_.reserve( window_size ); }
+		void set_fitness_tracking_window_size( size_t window_size ) { fitness_history_.reserve( window_size ); fitness_trend_tracker_.set_window_size( window_size ); }
 		size_t fitness_tracking_window_size() const { return fitness_history_.capacity(); }
+		void set_fitness_trend_estimator( trend_estimator e ) { fitness_trend_estimator_ = e; fitness_trend_step_ = no_index; }
+		trend_estimator fitness_trend_estimator() const { return fitness_trend_estimator_; }
 		xo::linear_function< float > fitness_trend() const;
 		float progress() const;
 		float predicted_fitness( size_t steps_ahead ) const;
@@ -69,6 +79,10 @@ namespace spot
 		virtual vector< string > optimizer_state_labels() const { return {}; }
 		virtual vector< par_t > optimizer_state_values() const { return {}; }
 
+		// migration
+		/// Add an external candidate to the next population, returns false if not supported.
+		virtual bool inject_candidate( const par_vec& point ) { return false; }
+
 		// properties
 		string name;
 
@@ -78,6 +92,7 @@ namespace spot
 		xo::profiler& profiler() { return profiler_; }
 
 	protected:
+		friend class optimizer_snapshot;
 		virtual bool internal_step() = 0;
 		par_vec& try_apply_boundary_transform( par_vec& v ) const;
 		vector< result<fitness_t> > evaluate( const search_point_vec& point_vec, priority_t prio = 0 );
@@ -90,15 +105,19 @@ namespace spot
 
 		// optimization info
 		index_t step_count_;
+		size_t evaluation_count_;
 		fitness_t best_fitness_;
 		search_point best_point_;
 		fitness_t current_step_best_fitness_;
 		fitness_vec current_step_fitnesses_;
 		search_point current_step_best_point_;
+		vector< double > current_step_evaluation_durations_;
 
 		// fitness tracking
 		size_t fitness_history_samples_;
 		xo::circular_deque< float > fitness_history_;
+		sliding_trend fitness_trend_tracker_;
+		trend_estimator fitness_trend_estimator_;
 		mutable xo::linear_function< float > fitness_trend_;
 		mutable index_t fitness_trend_step_;
 
@@ -123,6 +142,7 @@ namespace spot
 	template< typename T, typename... Args >
 	void optimizer::signal_reporters( T fn, Args&&... args ) {
 		XO_PROFILE_FUNCTION( profiler_ );
+		SPOT_TRACE_SCOPE( "optimizer::signal_reporters" );
 		try {
 			for ( auto& r : reporters_ )
 				std::mem_fn( fn )( *r, std::forward< Args >( args )... );
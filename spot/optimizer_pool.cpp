@@ -3,7 +3,8 @@
 #include "xo/system/log.h"
 #include "stop_condition.h"
 #include "xo/container/prop_node_tools.h"
-#include <future>
+#include <algorithm>
+#include <cmath>
 
 namespace spot
 {
@@ -12,13 +13,17 @@ namespace spot
 		virtual string what() const override { return "All optimizers have ended"; }
 		virtual bool test( const optimizer& opt ) override {
 			auto& pool = dynamic_cast<const optimizer_pool&>( opt );
-			bool stop = true;
-			for ( auto& o : pool.optimizers() )
-				stop &= o->test_stop_conditions() != nullptr;
-			return stop;
+			return pool.all_optimizers_stopped();
 		}
 	};
 
+	struct successive_halving_condition : public stop_condition
+	{
+		virtual string what() const override { return "Eliminated by successive halving"; }
+		virtual bool test( const optimizer& opt ) override { return eliminated_; }
+		bool eliminated_ = false;
+	};
+
 	optimizer_pool::optimizer_pool( const objective& o, evaluator& e, const prop_node& pn ) :
 		optimizer( o, e ),
 		INIT_MEMBER( pn, prediction_window_, 100 ),
@@ -27,22 +32,56 @@ namespace spot
 		INIT_MEMBER( pn, use_predicted_fitness_stop_condition_, false ),
 		INIT_MEMBER( pn, active_optimizations_, 6 ),
 		INIT_MEMBER( pn, concurrent_optimizations_, 3 ),
-		best_fitness_( o.info().worst_fitness() ),
-		best_optimizer_idx_( no_index )
+		INIT_MEMBER( pn, successive_halving_, false ),
+		INIT_MEMBER( pn, halving_min_steps_, 10 ),
+		INIT_MEMBER( pn, halving_reduction_factor_, 3 ),
+		INIT_MEMBER( pn, max_evaluations_, 0 ),
+		INIT_MEMBER( pn, migration_interval_, 0 ),
+		INIT_MEMBER( pn, migration_topology_, "ring" ),
+		best_optimizer_idx_( no_index ),
+		best_optimizer_info_( o.info() ),
+		scheduler_best_fitness_( o.info().worst_fitness() ),
+		scheduler_best_idx_( no_index ),
+		halving_round_steps_( halving_min_steps_ ),
+		stop_workers_( false )
 	{
+		xo_error_if( successive_halving_ && halving_reduction_factor_ < 2, "halving_reduction_factor must be at least 2" );
+		xo_error_if( migration_topology_ != "ring" && migration_topology_ != "best", "Unknown migration_topology: " + migration_topology_ );
 		add_stop_condition( std::make_unique< pool_stop_condition >() );
+		if ( max_evaluations_ > 0 )
+			add_stop_condition( std::make_unique< max_evaluations_condition >( max_evaluations_ ) );
+	}
+
+	optimizer_pool::~optimizer_pool()
+	{
+		// members are destroyed with the pool, so there's no need to finish their current step
+		for ( auto& o : optimizers_ )
+			o->interrupt();
+		stop_workers();
 	}
 
 	void optimizer_pool::push_back( u_ptr< optimizer > opt )
 	{
+		xo_error_if( !workers_.empty(), "Cannot add optimizers to a running optimizer_pool" );
 		opt->set_fitness_tracking_window_size( prediction_window_ );
 		if ( use_predicted_fitness_stop_condition_ )
 			opt->add_stop_condition(
 				std::make_unique< predicted_fitness_condition >(
 					info().worst_fitness(), prediction_look_ahead_, prediction_start_ ) );
+		if ( successive_halving_ )
+			opt->add_stop_condition( std::make_unique< successive_halving_condition >() );
+		members_.push_back( member_state{ compute_predicted_fitness( *opt ) } );
 		optimizers_.push_back( std::move( opt ) );
 	}
 
+	stop_condition* optimizer_pool::test_stop_conditions()
+	{
+		auto* sc = optimizer::test_stop_conditions();
+		if ( sc )
+			stop_workers(); // workers finish their current step
+		return sc;
+	}
+
 	bool optimizer_pool::interrupt()
 	{
 		for ( auto& o : optimizers_ )
@@ -53,21 +92,28 @@ namespace spot
 	objective_info optimizer_pool::make_updated_objective_info() const
 	{
 		xo_assert( best_optimizer_idx_ != no_index );
-		return optimizers_[best_optimizer_idx_]->make_updated_objective_info();
+		return best_optimizer_info_;
+	}
+
+	bool optimizer_pool::all_optimizers_stopped() const
+	{
+		// results of the final steps must be processed before the pool stops
+		std::scoped_lock lock( scheduler_mutex_ );
+		return step_results_.empty() && std::all_of( members_.begin(), members_.end(), []( const member_state& m ) { return m.stopped && !m.busy; } );
 	}
 
 	fitness_vec optimizer_pool::compute_predicted_fitnesses()
 	{
+		// uses the prediction of each member after its most recent step
 		fitness_vec priorities;
 
 		size_t active_count = 0;
-		for ( auto& o : optimizers_ )
+		for ( auto& m : members_ )
 		{
-			if ( active_count < active_optimizations_ && o->test_stop_conditions() == nullptr )
+			if ( active_count < active_optimizations_ && !m.stopped )
 			{
-				if ( o->current_step() >= prediction_start_ )
-					priorities.push_back( o->predicted_fitness( prediction_look_ahead_ ) );
-				else priorities.push_back( info().best_fitness() );
+				// NaN cannot be sorted, it is treated as the worst prediction
+				priorities.push_back( std::isnan( m.prediction ) ? info().worst_fitness() : m.prediction );
 				++active_count;
 			}
 			else priorities.push_back( info().worst_fitness() );
@@ -76,64 +122,283 @@ namespace spot
 		return priorities;
 	}
 
-	bool optimizer_pool::internal_step()
+	fitness_t optimizer_pool::compute_predicted_fitness( const optimizer& o ) const
 	{
-		xo_assert( optimizers_.size() > 0 );
+		if ( o.current_step() >= prediction_start_ )
+			return o.predicted_fitness( prediction_look_ahead_ );
+		else return info().best_fitness();
+	}
+
+	index_t optimizer_pool::select_next_optimizer()
+	{
+		if ( successive_halving_ )
+			return select_next_halving_optimizer();
+
+		// choose best active optimizer that is not running
+		auto predictions = compute_predicted_fitnesses();
+		auto best_indices = xo::sorted_indices( predictions, [&]( fitness_t a, fitness_t b ) { return info().is_better( a, b ); } );
+		for ( auto idx : best_indices )
+		{
+			if ( !info().is_better( predictions[idx], info().worst_fitness() ) )
+				break; // remaining optimizers are inactive
+			if ( !members_[idx].busy && !members_[idx].stopped )
+				return idx;
+		}
+
+		// active members with the worst prediction are stepped last, until they stop by themselves
+		size_t active_count = 0;
+		for ( index_t idx = 0; idx < members_.size() && active_count < active_optimizations_; ++idx )
+		{
+			auto& m = members_[idx];
+			if ( m.stopped )
+				continue;
+			if ( !m.busy )
+				return idx;
+			++active_count;
+		}
+		return no_index;
+	}
+
+	index_t optimizer_pool::select_next_halving_optimizer()
+	{
+		// choose the member with the fewest steps that still has budget in this round
+		index_t next = no_index;
+		for ( index_t i = 0; i < members_.size(); ++i )
+		{
+			auto& m = members_[i];
+			if ( !m.busy && !m.stopped && m.steps < halving_round_steps_ && ( next == no_index || m.steps < members_[next].steps ) )
+				next = i;
+		}
+		return next;
+	}
+
+	void optimizer_pool::update_halving_round()
+	{
+		// the round is complete when all remaining members have used their budget
+		vector< index_t > remaining;
+		for ( index_t i = 0; i < members_.size(); ++i )
+		{
+			auto& m = members_[i];
+			if ( m.busy || ( !m.stopped && m.steps < halving_round_steps_ ) )
+				return;
+			if ( !m.stopped )
+				remaining.push_back( i );
+		}
+		if ( remaining.size() <= 1 )
+			return;
+
+		// keep the best 1 / halving_reduction_factor_ members, stop the others
+		std::sort( remaining.begin(), remaining.end(), [&]( index_t a, index_t b ) { return info().is_better( members_[a].best_fitness, members_[b].best_fitness ); } );
+		auto keep = std::max<size_t>( 1, remaining.size() / halving_reduction_factor_ );
+		for ( auto it = remaining.begin() + keep; it != remaining.end(); ++it )
+		{
+			// the member is not running, so it's safe to signal its stop condition here
+			auto& o = *optimizers_[*it];
+			o.find_stop_condition<successive_halving_condition>().eliminated_ = true;
+			o.test_stop_conditions();
+			members_[*it].stopped = true;
+		}
+
+		// the last remaining member runs until it stops by itself
+		halving_round_steps_ = keep > 1 ? halving_round_steps_ * halving_reduction_factor_ : xo::constants<size_t>::max();
+		xo::log::debug( "optimizer_pool: successive halving kept ", keep, " of ", remaining.size(), " optimizers, next round steps=", halving_round_steps_ );
+	}
+
+	par_vec optimizer_pool::select_migrant( index_t idx )
+	{
+		auto& m = members_[idx];
+		if ( m.steps < m.migration_step + migration_interval_ )
+			return {};
+		m.migration_step = m.steps;
+
+		index_t source = no_index;
+		if ( migration_topology_ == "best" )
+			source = scheduler_best_idx_;
+		else for ( index_t k = 1; k < members_.size() && source == no_index; ++k )
+		{
+			// closest preceding member that has completed a step
+			auto i = ( idx + members_.size() - k ) % members_.size();
+			if ( !members_[i].best_point.empty() )
+				source = i;
+		}
+
+		// only migrate points that improve on the current best of the receiving member
+		if ( source == no_index || source == idx || m.best_point.empty() || !info().is_better( members_[source].best_fitness, m.best_fitness ) )
+			return {};
+		return members_[source].best_point;
+	}
+
+	bool optimizer_pool::is_idle()
+	{
+		auto busy = std::any_of( members_.begin(), members_.end(), []( const member_state& m ) { return m.busy; } );
+		return !busy && select_next_optimizer() == no_index;
+	}
 
-		if ( step_queue_.empty() )
+	optimizer_pool::step_result optimizer_pool::step_optimizer( index_t idx, fitness_t target_fitness, bool include_updated_info, const par_vec& migrant )
+	{
+		auto& o = *optimizers_[idx];
+		step_result r;
+		r.idx = idx;
+		try
 		{
-			// choose best active optimizer
-			auto predictions = compute_predicted_fitnesses();
-			auto best_indices = xo::sorted_indices( predictions, [&]( fitness_t a, fitness_t b ) { return info().is_better( a, b ); } );
+			if ( use_predicted_fitness_stop_condition_ )
+				o.find_stop_condition<predicted_fitness_condition>().fitness_ = target_fitness;
 
-			for ( auto it = best_indices.begin(); it != best_indices.end() && !optimizers_[*it]->test_stop_conditions(); ++it )
+			// the target may have changed since the previous step of this optimizer
+			r.stopped = o.test_stop_conditions() != nullptr;
+			if ( !r.stopped )
 			{
-				step_queue_.push_back( *it );
-				if ( ( it < best_indices.end() - 1 )
-					&& predictions[*it] != predictions[*( it + 1 )] // next one is worse
-					&& step_queue_.size() >= concurrent_optimizations_ )
-					break; // stop if the next one is worse
+				if ( !migrant.empty() )
+					o.inject_candidate( migrant );
+				r.stopped = o.step() != nullptr;
+				r.stepped = true;
 			}
+			r.prediction = compute_predicted_fitness( o );
+			r.steps = o.current_step();
 
-			string str = xo::stringf( "%d (%.0f):", current_step(), current_step() > 0 ? best_fitness() : 0.0 );
-			for ( int i = 0; i < optimizers_.size(); ++i )
+			if ( r.stepped )
 			{
-				auto& opt = *optimizers_[i];
-				auto bf = xo::clamped( opt.best_fitness(), fitness_t( -9999 ), fitness_t( 9999 ) );
-				auto pf = xo::clamped( predictions[i], fitness_t( -9999 ), fitness_t( 9999 ) );
-				str += xo::stringf( "\t%d/%.0f/%.0f", opt.current_step(), bf, pf );
+				r.best_fitness = o.best_fitness();
+				r.best_point = o.best_point().values();
+				r.current_step_fitnesses = o.current_step_fitnesses();
+				r.current_step_best_fitness = o.current_step_best_fitness();
+				r.current_step_best_point = o.current_step_best_point().values();
+				if ( include_updated_info || !info().is_better( target_fitness, r.best_fitness ) )
+					r.updated_info = std::make_unique< objective_info >( o.make_updated_objective_info() );
 			}
 		}
+		catch ( ... )
+		{
+			r.exception = std::current_exception();
+			r.stepped = r.stopped = true;
+		}
+		return r;
+	}
 
-		vector< std::future< index_t > > futures;
-		while ( !step_queue_.empty() && futures.size() < concurrent_optimizations_ )
+	void optimizer_pool::process_step_result( step_result& r )
+	{
+		evaluation_count_ += r.current_step_fitnesses.size();
+		bool new_best = best_optimizer_idx_ == no_index || is_better( r.best_fitness, best_fitness_ );
+		if ( new_best )
 		{
-			futures.push_back( std::async( [&]( index_t i ) { optimizers_[i]->step(); return i; }, step_queue_.front() ) );
-			step_queue_.pop_front();
+			// copy results if better
+			best_optimizer_idx_ = r.idx;
+			best_fitness_ = r.best_fitness;
+			best_point_.set_values( r.best_point );
+
+			// update target for predicted_fitness_condition
+			std::scoped_lock lock( scheduler_mutex_ );
+			scheduler_best_fitness_ = best_fitness_;
+			scheduler_best_idx_ = best_optimizer_idx_;
 		}
 
-		for ( auto& f : futures )
+		if ( r.idx == best_optimizer_idx_ )
 		{
-			auto idx = f.get();
-			bool new_best = best_optimizer_idx_ == no_index || is_better( optimizers_[idx]->best_fitness(), best_fitness_ );
-			if ( new_best )
-			{
-				// copy results if better
-				best_optimizer_idx_ = idx;
-				best_fitness_ = best_optimizer().best_fitness();
+			current_step_fitnesses_ = std::move( r.current_step_fitnesses );
+			current_step_best_fitness_ = r.current_step_best_fitness;
+			current_step_best_point_.set_values( r.current_step_best_point );
+			if ( r.updated_info )
+				best_optimizer_info_ = std::move( *r.updated_info );
+		}
+
+		if ( new_best )
+			signal_reporters( &reporter::on_new_best, *this, best_point(), best_fitness() );
 
-				// update prediction targets for all optimizers
-				if ( use_predicted_fitness_stop_condition_ )
-					for ( auto& o : optimizers() )
-						o->find_stop_condition<predicted_fitness_condition>().fitness_ = best_fitness();
+		// run post-evaluate callbacks (AFTER current_best is updated!)
+		signal_reporters( &reporter::on_post_evaluate_population, *this, search_point_vec(), current_step_fitnesses(), new_best );
+	}
+
+	bool optimizer_pool::internal_step()
+	{
+		xo_assert( optimizers_.size() > 0 );
+
+		if ( workers_.empty() )
+			start_workers();
+
+		// wait for at least one optimizer to finish its step
+		std::deque< step_result > results;
+		{
+			std::unique_lock lock( scheduler_mutex_ );
+			result_cv_.wait( lock, [&]() { return !step_results_.empty() || is_idle(); } );
+			results.swap( step_results_ );
+		}
+		worker_cv_.notify_all(); // workers may be waiting for room in step_results_
 
-				signal_reporters( &reporter::on_new_best, *this, best_point(), best_fitness() );
+		// process all results before rethrowing, so that no finished steps are lost
+		std::exception_ptr exception;
+		for ( auto& r : results )
+		{
+			if ( r.exception )
+			{
+				if ( !exception )
+					exception = r.exception;
 			}
+			else process_step_result( r );
+		}
+		if ( exception )
+			std::rethrow_exception( exception );
+
+		return !results.empty();
+	}
 
-			// run post-evaluate callbacks (AFTER current_best is updated!)
-			signal_reporters( &reporter::on_post_evaluate_population, *this, search_point_vec(), current_step_fitnesses(), new_best );
+	void optimizer_pool::start_workers()
+	{
+		stop_workers_ = false;
+		auto worker_count = std::max<size_t>( 1, concurrent_optimizations_ );
+		for ( index_t i = 0; i < worker_count; ++i )
+			workers_.emplace_back( &optimizer_pool::worker_func, this );
+	}
+
+	void optimizer_pool::stop_workers()
+	{
+		{
+			std::scoped_lock lock( scheduler_mutex_ );
+			stop_workers_ = true;
 		}
+		worker_cv_.notify_all();
+		for ( auto& w : workers_ )
+			w.join();
+		workers_.clear();
+	}
 
-		return true;
+	void optimizer_pool::worker_func()
+	{
+		std::unique_lock lock( scheduler_mutex_ );
+		while ( !stop_workers_ )
+		{
+			// don't run ahead too far if results are not being processed
+			auto idx = step_results_.size() < concurrent_optimizations_ ? select_next_optimizer() : no_index;
+			if ( idx == no_index )
+			{
+				worker_cv_.wait( lock );
+				continue;
+			}
+
+			members_[idx].busy = true;
+			auto target_fitness = scheduler_best_fitness_;
+			auto include_updated_info = idx == scheduler_best_idx_;
+			auto migrant = migration_interval_ > 0 ? select_migrant( idx ) : par_vec();
+			lock.unlock();
+
+			auto result = step_optimizer( idx, target_fitness, include_updated_info, migrant );
+
+			lock.lock();
+			auto& m = members_[idx];
+			m.busy = false;
+			m.stopped = result.stopped;
+			m.prediction = result.prediction;
+			m.steps = result.steps;
+			if ( result.stepped )
+			{
+				m.best_fitness = result.best_fitness;
+				m.best_point = result.best_point;
+				step_results_.push_back( std::move( result ) );
+			}
+			if ( successive_halving_ )
+				update_halving_round();
+
+			result_cv_.notify_one();
+			worker_cv_.notify_all();
+		}
 	}
 }
@@ -3,31 +3,35 @@
 #include "spot_types.h"
 #include "optimizer.h"
 #include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
 
 namespace spot
 {
-	/// Pool of independent optimizations, prioritized based on their predicted fitness.
+	/// Pool of optimizations, prioritized based on their predicted fitness.
+	/// Member steps are run by persistent worker threads; each worker re-queues as soon as its step is done.
+	/// Optionally, members periodically receive the best point of another member (island model).
 	class SPOT_API optimizer_pool : public optimizer
 	{
 	public:
 		optimizer_pool( const objective& o, evaluator& e, const prop_node& pn );
 		optimizer_pool( const optimizer_pool& ) = delete;
 		optimizer_pool& operator=( const optimizer_pool& ) = delete;
-		virtual ~optimizer_pool() {}
-
-		virtual const fitness_vec& current_step_fitnesses() const override { return best_optimizer().current_step_fitnesses(); }
-		virtual fitness_t current_step_best_fitness() const override { return best_optimizer().current_step_best_fitness(); }
-		virtual const search_point& current_step_best_point() const override { return best_optimizer().current_step_best_point(); }
-		virtual fitness_t best_fitness() const override { return best_optimizer().best_fitness(); }
-		virtual const search_point& best_point() const override { return best_optimizer().best_point(); }
+		virtual ~optimizer_pool();
 
 		void push_back( u_ptr< optimizer > opt );
 		const vector< u_ptr< optimizer > >& optimizers() const { return optimizers_; }
 		size_t size() const { return optimizers_.size(); }
 
+		virtual stop_condition* test_stop_conditions() override;
 		virtual bool interrupt() override;
 		virtual objective_info make_updated_objective_info() const override;
 
+		/// True if all member optimizations have stopped and their results are processed.
+		bool all_optimizers_stopped() const;
+
 		/// Number of generations on which to base the prediction.
 		size_t prediction_window_;
 
@@ -46,15 +50,83 @@ namespace spot
 		/// Maximum number of optimizations running concurrently.
 		size_t concurrent_optimizations_;
 
+		/// Schedule members using successive halving instead of predicted fitness.
+		bool successive_halving_;
+
+		/// Number of steps each member receives in the first successive halving round.
+		size_t halving_min_steps_;
+
+		/// Fraction of members (1 / factor) that survive each successive halving round.
+		size_t halving_reduction_factor_;
+
+		/// Total number of evaluations of all members, zero means no limit.
+		size_t max_evaluations_;
+
+		/// Number of member steps between migrations, zero disables migration.
+		size_t migration_interval_;
+
+		/// Migration source: "ring" (preceding member) or "best" (best member of the pool).
+		string migration_topology_;
+
 	protected:
-		fitness_t best_fitness_;
+		struct member_state
+		{
+			fitness_t prediction;
+			bool busy = false;
+			bool stopped = false;
+			size_t steps = 0;
+			fitness_t best_fitness = 0;
+			par_vec best_point;
+			size_t migration_step = 0;
+		};
+
+		// snapshot of a member after a step, taken by the worker that performed the step
+		struct step_result
+		{
+			index_t idx = no_index;
+			bool stepped = false;
+			bool stopped = false;
+			fitness_t prediction = 0;
+			size_t steps = 0;
+			fitness_t best_fitness = 0;
+			par_vec best_point;
+			fitness_vec current_step_fitnesses;
+			fitness_t current_step_best_fitness = 0;
+			par_vec current_step_best_point;
+			u_ptr< objective_info > updated_info;
+			std::exception_ptr exception;
+		};
 
 		virtual fitness_vec compute_predicted_fitnesses();
+		virtual fitness_t compute_predicted_fitness( const optimizer& o ) const;
 		virtual bool internal_step() override;
 
+		index_t select_next_optimizer();
+		index_t select_next_halving_optimizer();
+		void update_halving_round();
+		par_vec select_migrant( index_t idx );
+		bool is_idle();
+		step_result step_optimizer( index_t idx, fitness_t target_fitness, bool include_updated_info, const par_vec& migrant );
+		void process_step_result( step_result& r );
+
+		void start_workers();
+		void stop_workers();
+		void worker_func();
+
 		vector< u_ptr< optimizer > > optimizers_;
-		std::deque< index_t > step_queue_;
 		index_t best_optimizer_idx_;
-		const optimizer& best_optimizer() const { xo_assert( best_optimizer_idx_ < optimizers_.size() ); return *optimizers_[best_optimizer_idx_]; }
+		objective_info best_optimizer_info_;
+
+		// scheduler state, protected by scheduler_mutex_
+		vector< member_state > members_;
+		std::deque< step_result > step_results_;
+		fitness_t scheduler_best_fitness_;
+		index_t scheduler_best_idx_;
+		size_t halving_round_steps_;
+		bool stop_workers_;
+		mutable std::mutex scheduler_mutex_;
+		std::condition_variable worker_cv_;
+		std::condition_variable result_cv_;
+		vector< std::thread > workers_;
 	};
 }
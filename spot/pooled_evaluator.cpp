@@ -1,106 +1,428 @@
 #include "pooled_evaluator.h"
 #include "xo/system/log.h"
 #include "objective.h"
+#include "tracer.h"
+#include "xo/numerical/math.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <numeric>
 #include <iostream>
 
 namespace spot
 {
+	// 1-minute load average of the system, or a negative value if unavailable
+	static double system_load_average()
+	{
+#ifdef _WIN32
+		return -1.0;
+#else
+		double load = -1.0;
+		return getloadavg( &load, 1 ) == 1 ? load : -1.0;
+#endif
+	}
+
+	// ranges of a parallel_for, which are claimed by the calling thread and idle workers
+	struct pooled_evaluator::parallel_job
+	{
+		parallel_job( size_t n, size_t grain_size, const range_function& body ) :
+			body( body ), n( n ), grain_size( grain_size ), next( 0 ), remaining( ( n + grain_size - 1 ) / grain_size )
+		{}
+
+		void run_ranges() {
+			for ( auto begin = next.fetch_add( grain_size ); begin < n; begin = next.fetch_add( grain_size ) )
+			{
+				try
+				{
+					SPOT_TRACE_SCOPE( "task_scheduler::range" );
+					body( begin, std::min( begin + grain_size, n ) );
+				}
+				catch ( ... )
+				{
+					std::scoped_lock lock( mutex );
+					if ( !error )
+						error = std::current_exception();
+				}
+				if ( --remaining == 0 )
+				{
+					std::scoped_lock lock( mutex );
+					done_cv.notify_all();
+				}
+			}
+		}
+
+		void wait() {
+			std::unique_lock lock( mutex );
+			done_cv.wait( lock, [&]() { return remaining == 0; } );
+			if ( error )
+				std::rethrow_exception( error );
+		}
+
+		const range_function& body;
+		const size_t n;
+		const size_t grain_size;
+		std::atomic< size_t > next;
+		std::atomic< size_t > remaining;
+		std::mutex mutex;
+		std::condition_variable done_cv;
+		std::exception_ptr error;
+	};
+
 	pooled_evaluator::pooled_evaluator( int max_threads, xo::thread_priority thread_prio ) :
 		max_threads_( max_threads ),
-		thread_prio_( thread_prio )
+		thread_prio_( thread_prio ),
+		token_pool_( nullptr ),
+		min_task_duration_( 0 ),
+		stop_signal_( false ),
+		target_threads_( 0 ),
+		worker_count_( 0 ),
+		max_pending_( 0 ),
+		last_busy_time_( 0 )
 	{
 		start_threads();
 	}
 
 	pooled_evaluator::~pooled_evaluator()
 	{
-		std::scoped_lock lock( queue_mutex_ );
-		if ( !queue_.empty() )
-			xo::log::error( "destroying pooled_evaluator with non-empty queue" );
+		{
+			// workers need the queue mutex to wake up, so release it before stopping them
+			std::scoped_lock lock( queue_mutex_ );
+			if ( !queue_.empty() )
+				xo::log::error( "destroying pooled_evaluator with non-empty queue" );
+		}
 		stop_threads();
 	}
 
 	vector< result<fitness_t> > pooled_evaluator::evaluate( const objective& o, const search_point_vec& point_vec, const xo::stop_token& st, priority_t prio )
 	{
-		// prepare vector of tasks and futures
-		vector< std::future< result<fitness_t> > > futures;
-		futures.reserve( point_vec.size() );
+		// evaluations of cheap objectives are grouped into chunks, to reduce the overhead per point
+		vector< result<fitness_t> > results( point_vec.size() );
+		auto& durations = thread_evaluation_durations();
+		durations.resize( point_vec.size() );
+		vector< evaluator_metrics::task > metric_tasks;
+		metric_tasks.reserve( point_vec.size() );
+		for ( index_t i = 0; i < point_vec.size(); ++i )
+			metric_tasks.push_back( metrics_.queue_task() );
+
+		vector< std::future< void > > futures;
 		vector< eval_task > tasks;
-		tasks.reserve( point_vec.size() );
-		for ( const auto& point : point_vec )
+		const auto chunk = chunk_size( o, point_vec.size() );
+		for ( index_t begin = 0; begin < point_vec.size(); begin += chunk )
 		{
-			tasks.emplace_back( [&]() { return o.evaluate_noexcept( point, st ); } );
+			auto end = std::min( begin + chunk, point_vec.size() );
+			tasks.emplace_back( [this, &o, &point_vec, &st, &results, &durations, &metric_tasks, begin, end]( objective_context_cache& cc ) {
+				objective_context* context = nullptr;
+				bool has_context = false;
+				for ( auto i = begin; i < end; ++i )
+				{
+					if ( st.stop_requested() )
+					{
+						metrics_.cancel_task( metric_tasks[i] );
+						durations[i] = 0;
+						results[i] = xo::error_message( evaluation_cancelled_message );
+						continue;
+					}
+					SPOT_TRACE_SCOPE( "evaluator::evaluate" );
+					if ( !has_context )
+					{
+						context = cc.get( o );
+						has_context = true;
+					}
+					metrics_.start_task( metric_tasks[i] );
+					results[i] = o.evaluate_noexcept( point_vec[i], st, context );
+					durations[i] = metrics_.finish_task( metric_tasks[i], !results[i] );
+				}
+				} );
 			futures.emplace_back( tasks.back().get_future() );
 		}
 
+		size_t pending = 0;
 		{
 			// add tasks to end of queue
 			std::scoped_lock lock( queue_mutex_ );
-			std::move( tasks.begin(), tasks.end(), std::back_inserter( queue_ ) );
+			for ( auto& t : tasks )
+				queue_.emplace_back( std::move( t ), st );
+			pending = queue_.size();
 		}
 
 		// worker threads are notified after the lock is released
 		queue_cv_.notify_all();
 		tasks.clear(); // these tasks are moved-out and cleared for clarity
+		update_autoscale( pending );
 
-		vector< result<fitness_t> > results;
-		results.reserve( point_vec.size() );
 		for ( auto& f : futures )
-			results.push_back( f.get() );
+		{
+			// queued tasks are completed by this thread after a stop request, so they don't wait for a worker
+			if ( st.stop_possible() )
+				while ( f.wait_for( std::chrono::milliseconds( 10 ) ) != std::future_status::ready )
+					if ( st.stop_requested() )
+						run_cancelled_tasks();
+			f.get();
+		}
+
+		// the mean over all points is robust against preempted evaluations
+		if ( !st.stop_requested() && !point_vec.empty() )
+			update_point_cost( o, std::accumulate( durations.begin(), durations.end(), 0.0 ) / durations.size() );
+
 		return results;
 	}
 
-	void pooled_evaluator::set_max_threads( int thread_count, xo::thread_priority prio )
+	size_t pooled_evaluator::chunk_size( const objective& o, size_t points ) const
+	{
+		auto cost = point_cost( o );
+		if ( cost <= 0 || cost >= min_task_duration_ )
+			return 1;
+
+		// keep at least two chunks per worker, for load balancing
+		auto max_chunk = std::max< size_t >( 1, points / ( 2 * std::max< size_t >( 1, thread_count() ) ) );
+		return xo::clamped< size_t >( size_t( min_task_duration_ / cost ), 1, max_chunk );
+	}
+
+	double pooled_evaluator::point_cost( const objective& o ) const
+	{
+		std::scoped_lock lock( point_cost_mutex_ );
+		for ( auto& [id, cost] : point_costs_ )
+			if ( id == o.id() )
+				return cost;
+		return 0;
+	}
+
+	void pooled_evaluator::update_point_cost( const objective& o, double cost )
+	{
+		// exponential moving average per objective, only a few recently used objectives are kept
+		std::scoped_lock lock( point_cost_mutex_ );
+		for ( auto& [id, prev] : point_costs_ )
+		{
+			if ( id == o.id() )
+			{
+				prev += 0.5 * ( cost - prev );
+				return;
+			}
+		}
+		if ( point_costs_.size() >= 8 )
+			point_costs_.erase( point_costs_.begin() );
+		point_costs_.emplace_back( o.id(), cost );
+	}
+
+	void pooled_evaluator::run_cancelled_tasks()
 	{
-		if ( max_threads_ != thread_count || thread_prio_ != prio )
+		vector< eval_task > cancelled;
 		{
-			max_threads_ = thread_count;
-			thread_prio_ = prio;
-			stop_threads();
-			start_threads();
+			std::scoped_lock lock( queue_mutex_ );
+			auto it = std::stable_partition( queue_.begin(), queue_.end(), []( const auto& t ) { return !t.second.stop_requested(); } );
+			for ( auto cit = it; cit != queue_.end(); ++cit )
+				cancelled.emplace_back( std::move( cit->first ) );
+			queue_.erase( it, queue_.end() );
 		}
+
+		// cancelled tasks return without using the context cache
+		objective_context_cache context_cache;
+		for ( auto& t : cancelled )
+			t( context_cache );
+	}
+
+	void pooled_evaluator::set_max_threads( int thread_count, xo::thread_priority prio )
+	{
+		// workers apply the new priority before their next task
+		max_threads_ = thread_count;
+		thread_prio_ = prio;
+		resize( thread_count > 0 ? thread_count : std::thread::hardware_concurrency() + thread_count );
+	}
+
+	size_t pooled_evaluator::thread_count() const
+	{
+		std::scoped_lock lock( queue_mutex_ );
+		return target_threads_;
+	}
+
+	void pooled_evaluator::set_autoscale( const autoscale_options& options )
+	{
+		std::scoped_lock lock( autoscale_mutex_ );
+		autoscale_ = options;
+		last_autoscale_ = std::chrono::steady_clock::time_point();
+		max_pending_ = 0;
+		last_busy_time_ = metrics_.snapshot().busy_time;
+	}
+
+	void pooled_evaluator::disable_autoscale()
+	{
+		std::scoped_lock lock( autoscale_mutex_ );
+		autoscale_.reset();
 	}
 
 	void pooled_evaluator::start_threads()
 	{
-		if ( !threads_.empty() )
-			stop_threads();
-		stop_signal_ = false;
-		auto thread_count = max_threads_ > 0 ? max_threads_ : std::thread::hardware_concurrency() + max_threads_;
-		for ( index_t i = 0; i < thread_count; ++i )
-			threads_.emplace_back( &pooled_evaluator::thread_func, this );
-		xo::log::debug( "pooled_evaluator started threads: ", thread_count );
+		resize( max_threads_ > 0 ? max_threads_ : std::thread::hardware_concurrency() + max_threads_ );
 	}
 
 	void pooled_evaluator::stop_threads()
 	{
-		stop_signal_ = true;
+		std::scoped_lock threads_lock( threads_mutex_ );
+		{
+			std::scoped_lock lock( queue_mutex_ );
+			stop_signal_ = true;
+		}
 		queue_cv_.notify_all();
-		while ( !threads_.empty() )
+		for ( auto& t : threads_ )
+			t.join();
+		threads_.clear();
+
+		std::scoped_lock lock( queue_mutex_ );
+		stop_signal_ = false;
+		target_threads_ = worker_count_ = 0;
+		retired_.clear();
+	}
+
+	void pooled_evaluator::resize( size_t thread_count )
+	{
+		std::scoped_lock threads_lock( threads_mutex_ );
+		join_retired_threads();
+
+		size_t new_threads = 0;
 		{
-			threads_.back().join();
-			threads_.pop_back();
+			std::scoped_lock lock( queue_mutex_ );
+			target_threads_ = thread_count;
+			if ( worker_count_ < target_threads_ )
+			{
+				new_threads = target_threads_ - worker_count_;
+				worker_count_ = target_threads_;
+			}
+		}
+		queue_cv_.notify_all(); // surplus workers retire when they are idle
+
+		for ( index_t i = 0; i < new_threads; ++i )
+			threads_.emplace_back( &pooled_evaluator::thread_func, this );
+		metrics_.set_workers( thread_count );
+		xo::log::debug( "pooled_evaluator threads: ", thread_count );
+	}
+
+	void pooled_evaluator::join_retired_threads()
+	{
+		vector< std::thread::id > retired;
+		{
+			std::scoped_lock lock( queue_mutex_ );
+			retired.swap( retired_ );
+		}
+		for ( auto id : retired )
+		{
+			auto it = std::find_if( threads_.begin(), threads_.end(), [&]( auto& t ) { return t.get_id() == id; } );
+			it->join();
+			threads_.erase( it );
 		}
 	}
 
+	void pooled_evaluator::update_autoscale( size_t pending )
+	{
+		// concurrent calls skip the update
+		std::unique_lock lock( autoscale_mutex_, std::try_to_lock );
+		if ( !lock.owns_lock() || !autoscale_ )
+			return;
+
+		max_pending_ = std::max( max_pending_, pending );
+		auto now = std::chrono::steady_clock::now();
+		auto elapsed = std::chrono::duration< double >( now - last_autoscale_ ).count();
+		if ( elapsed < autoscale_->interval )
+			return;
+
+		// the system load includes our own workers, estimated from their busy time
+		size_t hardware_threads = std::max( 1u, std::thread::hardware_concurrency() );
+		auto busy_time = metrics_.snapshot().busy_time;
+		auto own_load = last_autoscale_ != std::chrono::steady_clock::time_point() ? std::max( 0.0, busy_time - last_busy_time_ ) / elapsed : 0.0;
+		auto load = autoscale_->load_average ? autoscale_->load_average() : system_load_average();
+		size_t available = hardware_threads;
+		if ( load >= 0 )
+			available = size_t( std::max( 0.0, std::round( hardware_threads - std::max( 0.0, load - own_load ) ) ) );
+
+		auto max_threads = autoscale_->max_threads > 0 ? autoscale_->max_threads : hardware_threads;
+		auto desired = xo::clamped( std::min( available, max_pending_ ), std::max< size_t >( 1, autoscale_->min_threads ), max_threads );
+		last_autoscale_ = now;
+		last_busy_time_ = busy_time;
+		max_pending_ = 0;
+		if ( desired != thread_count() )
+			resize( desired );
+	}
+
 	void pooled_evaluator::thread_func()
 	{
-		xo::set_thread_priority( thread_prio_ );
-		while ( !stop_signal_ )
+		auto prio = thread_prio_.load();
+		xo::set_thread_priority( prio );
+		objective_context_cache context_cache; // contexts are owned by this worker
+		task_scheduler::set_current( this );
+		std::unique_lock lock( queue_mutex_ );
+		while ( true )
 		{
-			eval_task task;
+			queue_cv_.wait( lock, [&]() { return stop_signal_ || worker_count_ > target_threads_ || !queue_.empty() || !jobs_.empty(); } );
+			if ( stop_signal_ )
+				break;
+			if ( worker_count_ > target_threads_ )
+			{
+				// retire, this thread is joined by the next resize or stop
+				--worker_count_;
+				retired_.push_back( std::this_thread::get_id() );
+				break;
+			}
+
+			if ( queue_.empty() )
 			{
-				std::unique_lock lock( queue_mutex_ );
-				while ( queue_.empty() )
+				// help with a parallel_for of an objective that is evaluated by another worker
+				auto job = jobs_.front();
+				lock.unlock();
 				{
-					queue_cv_.wait( lock );
-					if ( stop_signal_ )
-						return;
+					cpu_token token( token_pool_ );
+					job->run_ranges();
 				}
-				task = std::move( queue_.front() );
-				queue_.pop_front();
+				lock.lock();
+				remove_job( *job ); // all ranges have started
+				continue;
 			}
-			task();
+
+			auto [task, stop] = std::move( queue_.front() );
+			queue_.pop_front();
+			lock.unlock();
+
+			if ( auto p = thread_prio_.load(); p != prio )
+				xo::set_thread_priority( prio = p );
+			if ( stop.stop_requested() )
+				task( context_cache ); // cancelled tasks don't need a cpu token
+			else
+			{
+				cpu_token token( token_pool_ );
+				task( context_cache );
+			}
+			lock.lock();
+		}
+		task_scheduler::set_current( nullptr );
+	}
+
+	void pooled_evaluator::parallel_for( size_t n, size_t grain_size, const range_function& body )
+	{
+		grain_size = std::max< size_t >( 1, grain_size );
+		if ( n <= grain_size )
+		{
+			if ( n > 0 )
+				body( 0, n );
+			return;
+		}
+
+		// idle workers help, but the calling thread runs ranges until none are left, so it never waits for a worker
+		auto job = std::make_shared< parallel_job >( n, grain_size, body );
+		{
+			std::scoped_lock lock( queue_mutex_ );
+			jobs_.push_back( job );
 		}
+		queue_cv_.notify_all();
+		job->run_ranges();
+		{
+			std::scoped_lock lock( queue_mutex_ );
+			remove_job( *job );
+		}
+		job->wait();
+	}
+
+	void pooled_evaluator::remove_job( const parallel_job& job )
+	{
+		auto it = std::find_if( jobs_.begin(), jobs_.end(), [&]( const auto& j ) { return j.get() == &job; } );
+		if ( it != jobs_.end() )
+			jobs_.erase( it );
 	}
 }
@@ -2,14 +2,31 @@
 
 #include "spot_types.h"
 #include "evaluator.h"
+#include "objective.h"
+#include "cpu_token_pool.h"
+#include "task_scheduler.h"
 #include "xo/thread/thread_priority.h"
+#include <chrono>
+#include <functional>
 #include <future>
 #include <mutex>
 #include <deque>
+#include <optional>
 
 namespace spot
 {
-	class SPOT_API pooled_evaluator : public evaluator
+	/// Settings for adjusting the number of pooled_evaluator threads to queue depth and system load.
+	struct autoscale_options
+	{
+		size_t min_threads = 1;
+		size_t max_threads = 0; // 0 uses the number of hardware threads
+		double interval = 10.0; // minimum number of seconds between adjustments
+		std::function< double() > load_average; // system load, empty uses the 1-minute load average of the system
+	};
+
+	/// Evaluator with persistent worker threads. Objectives can use idle workers for parallelism within
+	/// an evaluation through task_scheduler::current().
+	class SPOT_API pooled_evaluator : public evaluator, public task_scheduler
 	{
 	public:
 		pooled_evaluator( int max_threads = 0, xo::thread_priority thread_prio = xo::thread_priority::low );
@@ -17,23 +34,68 @@ namespace spot
 
 		virtual vector< result<fitness_t> > evaluate( const objective& o, const search_point_vec& point_vec, const xo::stop_token& st, priority_t prio = 0 ) override;
 
+		/// Resize the pool while evaluations are running: new workers start immediately,
+		/// surplus workers retire after their current task.
 		void set_max_threads( int max_threads, xo::thread_priority prio );
+		size_t thread_count() const;
+
+		/// Workers acquire a token from pool before each evaluation, null disables this.
+		void set_cpu_token_pool( cpu_token_pool* pool ) { token_pool_ = pool; }
+
+		/// Adjust the number of threads on each call to evaluate(), based on the number of queued
+		/// evaluations and the load of other processes.
+		void set_autoscale( const autoscale_options& options );
+		void disable_autoscale();
+
+		/// Points that take less than this number of seconds to evaluate are grouped into a single task.
+		/// Disabled (0) by default, 1e-4 is a reasonable value for cheap objectives.
+		void set_min_task_duration( double seconds ) { min_task_duration_ = seconds; }
+		/// Number of points per task for the current estimate of the evaluation cost of an objective.
+		size_t chunk_size( const objective& o, size_t points ) const;
+
+		virtual void parallel_for( size_t n, size_t grain_size, const range_function& body ) override;
 
 	protected:
 		void start_threads();
 		void stop_threads();
+		void resize( size_t thread_count );
+		void join_retired_threads();
+		void update_autoscale( size_t pending );
+		void run_cancelled_tasks();
+		double point_cost( const objective& o ) const;
+		void update_point_cost( const objective& o, double cost );
+
+		struct parallel_job;
+		void remove_job( const parallel_job& job );
 
 		void thread_func();
 
+		std::mutex threads_mutex_;
 		std::vector< std::thread > threads_;
-		std::atomic_bool stop_signal_;
 
 		int max_threads_;
-		xo::thread_priority thread_prio_;
+		std::atomic< xo::thread_priority > thread_prio_;
+		std::atomic< cpu_token_pool* > token_pool_;
+		std::atomic< double > min_task_duration_;
 
-		using eval_task = std::packaged_task< xo::result<fitness_t>() >;
-		std::mutex queue_mutex_;
+		// average evaluation time in seconds of recently used objectives, by objective::id()
+		mutable std::mutex point_cost_mutex_;
+		vector< pair< size_t, double > > point_costs_;
+
+		using eval_task = std::packaged_task< void( objective_context_cache& ) >;
+		mutable std::mutex queue_mutex_;
 		std::condition_variable queue_cv_;
-		std::deque< eval_task > queue_;
+		std::deque< pair< eval_task, xo::stop_token > > queue_;
+		std::deque< std::shared_ptr< parallel_job > > jobs_;
+		bool stop_signal_;
+		size_t target_threads_;
+		size_t worker_count_; // workers that have not retired
+		vector< std::thread::id > retired_;
+
+		std::mutex autoscale_mutex_;
+		std::optional< autoscale_options > autoscale_;
+		std::chrono::steady_clock::time_point last_autoscale_;
+		size_t max_pending_;
+		double last_busy_time_;
 	};
 }
@@ -0,0 +1,152 @@
+#include "population_log.h"
+#include "binary_io.h"
+
+#include "xo/system/assert.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace spot
+{
+	// header layout: magic, version, dim, par_info (name length + chars, mean, std, min, max)
+	// record layout: step, count, points (count x dim), fitnesses (count), durations (count)
+	// index layout: step, offset
+	static const char population_log_magic[8] = { 'S', 'P', 'O', 'T', 'P', 'O', 'P', 'L' };
+	static const uint32_t population_log_version = 1;
+
+	static path population_log_index_filename( const path& filename )
+	{
+		return path( filename.str() + ".idx" );
+	}
+
+	void population_log_writer::open( const path& filename, const objective_info& info )
+	{
+		str_ = std::ofstream( filename.str(), std::ios::binary );
+		index_str_ = std::ofstream( population_log_index_filename( filename ).str(), std::ios::binary );
+		xo_error_if( !str_.good() || !index_str_.good(), "Could not open " + filename.str() );
+		dim_ = info.dim();
+
+		str_.write( population_log_magic, sizeof( population_log_magic ) );
+		write_binary( str_, population_log_version );
+		write_binary( str_, uint32_t( dim_ ) );
+		for ( auto& pi : info )
+		{
+			write_binary( str_, uint32_t( pi.name.size() ) );
+			str_.write( pi.name.data(), pi.name.size() );
+			for ( auto v : { pi.mean, pi.std, pi.min, pi.max } )
+				write_binary( str_, double( v ) );
+		}
+	}
+
+	void population_log_writer::write( size_t step, const search_point_vec& pop, const fitness_vec& fitnesses, const vector< double >& durations )
+	{
+		xo_error_if( fitnesses.size() != pop.size(), "Number of fitnesses does not match population size" );
+		xo_error_if( !durations.empty() && durations.size() != pop.size(), "Number of durations does not match population size" );
+
+		write_binary( index_str_, uint64_t( step ) );
+		write_binary( index_str_, uint64_t( str_.tellp() ) );
+
+		write_binary( str_, uint64_t( step ) );
+		write_binary( str_, uint64_t( pop.size() ) );
+
+		// write all values at once
+		buffer_.clear();
+		for ( auto& sp : pop )
+		{
+			xo_assert( sp.size() == dim_ );
+			buffer_.insert( buffer_.end(), sp.values().begin(), sp.values().end() );
+		}
+		buffer_.insert( buffer_.end(), fitnesses.begin(), fitnesses.end() );
+		if ( durations.empty() )
+			buffer_.insert( buffer_.end(), pop.size(), std::numeric_limits< double >::quiet_NaN() );
+		else buffer_.insert( buffer_.end(), durations.begin(), durations.end() );
+		str_.write( reinterpret_cast<const char*>( buffer_.data() ), buffer_.size() * sizeof( double ) );
+	}
+
+	population_log_reader::population_log_reader( const path& filename ) :
+		str_( filename.str(), std::ios::binary )
+	{
+		xo_error_if( !str_.good(), "Could not open " + filename.str() );
+
+		char magic[sizeof( population_log_magic )];
+		str_.read( magic, sizeof( magic ) );
+		xo_error_if( !str_ || std::memcmp( magic, population_log_magic, sizeof( magic ) ) != 0, filename.str() + " is not a population log" );
+		auto version = read_binary< uint32_t >( str_ );
+		xo_error_if( version != population_log_version, "Unsupported population log version in " + filename.str() );
+
+		auto dim = read_binary< uint32_t >( str_ );
+		for ( uint32_t i = 0; i < dim && str_; ++i )
+		{
+			string name( read_binary< uint32_t >( str_ ), '\0' );
+			str_.read( name.data(), name.size() );
+			auto mean = read_binary< double >( str_ );
+			auto std = read_binary< double >( str_ );
+			auto min = read_binary< double >( str_ );
+			auto max = read_binary< double >( str_ );
+			info_.add( par_info( name, par_t( mean ), par_t( std ), par_t( min ), par_t( max ) ) );
+		}
+		xo_error_if( !str_, "Could not read header of " + filename.str() );
+
+		std::ifstream index_str( population_log_index_filename( filename ).str(), std::ios::binary );
+		xo_error_if( !index_str.good(), "Could not open index of " + filename.str() );
+		while ( true )
+		{
+			auto step = read_binary< uint64_t >( index_str );
+			auto offset = read_binary< uint64_t >( index_str );
+			if ( !index_str )
+				break;
+			index_.emplace_back( size_t( step ), std::streamoff( offset ) );
+		}
+
+		// the log is append-only, so only the last record may be incomplete
+		str_.seekg( 0, std::ios::end );
+		auto file_size = std::streamoff( str_.tellg() );
+		while ( !index_.empty() )
+		{
+			str_.clear();
+			str_.seekg( index_.back().second + std::streamoff( sizeof( uint64_t ) ) );
+			auto count = read_binary< uint64_t >( str_ );
+			auto record_size = std::streamoff( 2 * sizeof( uint64_t ) + count * ( dim + 2 ) * sizeof( double ) );
+			if ( str_ && index_.back().second + record_size <= file_size )
+				break;
+			index_.pop_back();
+		}
+	}
+
+	index_t population_log_reader::find_step( size_t step ) const
+	{
+		auto it = std::lower_bound( index_.begin(), index_.end(), step, []( const auto& e, size_t s ) { return e.first < s; } );
+		return it != index_.end() && it->first == step ? index_t( it - index_.begin() ) : no_index;
+	}
+
+	population_record population_log_reader::read( index_t record ) const
+	{
+		xo_error_if( record >= index_.size(), "Invalid population log record" );
+		str_.clear();
+		str_.seekg( index_[record].second );
+
+		population_record r;
+		r.step = size_t( read_binary< uint64_t >( str_ ) );
+		auto count = size_t( read_binary< uint64_t >( str_ ) );
+		vector< double > values( count * ( info_.dim() + 2 ) );
+		str_.read( reinterpret_cast<char*>( values.data() ), values.size() * sizeof( double ) );
+		xo_error_if( !str_, "Error reading population log" );
+
+		auto it = values.begin();
+		for ( index_t i = 0; i < count; ++i, it += info_.dim() )
+			r.points.emplace_back( it, it + info_.dim() );
+		r.fitnesses.assign( it, it + count );
+		r.durations.assign( it + count, values.end() );
+		return r;
+	}
+
+	void population_log_reader::write_par_file( index_t record, index_t individual, const path& filename ) const
+	{
+		auto r = read( record );
+		xo_error_if( individual >= r.points.size(), "Invalid individual index" );
+		std::ofstream str( filename.str() );
+		xo_error_if( !str.good(), "Could not open " + filename.str() );
+		str << search_point( info_, r.points[individual] );
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "spot_types.h"
+#include "objective_info.h"
+#include "search_point.h"
+#include <fstream>
+
+namespace spot
+{
+	/// Population of a single generation, as stored in a population log.
+	struct SPOT_API population_record
+	{
+		size_t step = 0;
+		vector< par_vec > points;
+		fitness_vec fitnesses;
+		vector< double > durations; // in seconds, NaN if not measured
+	};
+
+	/// Append-only binary log with one record per generation, containing all points, fitnesses and evaluation durations.
+	/// Record offsets are written to a separate index file (log filename + ".idx") for random access.
+	class SPOT_API population_log_writer
+	{
+	public:
+		population_log_writer() {}
+		population_log_writer( const path& filename, const objective_info& info ) { open( filename, info ); }
+
+		void open( const path& filename, const objective_info& info );
+		bool is_open() const { return str_.is_open(); }
+
+		/// Write a record, durations may be empty.
+		void write( size_t step, const search_point_vec& pop, const fitness_vec& fitnesses, const vector< double >& durations );
+		void flush() { str_.flush(); index_str_.flush(); }
+
+	private:
+		std::ofstream str_;
+		std::ofstream index_str_;
+		size_t dim_ = 0;
+		vector< double > buffer_;
+	};
+
+	/// Random access to the records of a population log.
+	class SPOT_API population_log_reader
+	{
+	public:
+		population_log_reader( const path& filename );
+
+		const objective_info& info() const { return info_; }
+		size_t size() const { return index_.size(); }
+
+		/// Index of the record of step, or no_index if not found.
+		index_t find_step( size_t step ) const;
+		population_record read( index_t record ) const;
+
+		/// Write a single individual of a record to a .par file.
+		void write_par_file( index_t record, index_t individual, const path& filename ) const;
+
+	private:
+		mutable std::ifstream str_;
+		objective_info info_;
+		vector< pair< size_t, std::streamoff > > index_;
+	};
+}
@@ -0,0 +1,121 @@
+#include "simd_dispatch.h"
+#include "cma_kernels.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "xo/system/assert.h"
+#include "xo/system/log.h"
+
+#if ( defined( __GNUC__ ) || defined( __clang__ ) ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#	define SPOT_SIMD_DISPATCH 1
+#else
+#	define SPOT_SIMD_DISPATCH 0
+#endif
+
+namespace spot
+{
+	// the scalar kernels use the default target of the build
+	namespace simd_scalar
+	{
+#		define SPOT_SIMD_ATTRIBUTES
+#		define SPOT_SIMD_VECTOR_BYTES 32
+#		define SPOT_SIMD_LEVEL simd_level::scalar
+#		include "simd_kernels.inl"
+#		undef SPOT_SIMD_ATTRIBUTES
+#		undef SPOT_SIMD_VECTOR_BYTES
+#		undef SPOT_SIMD_LEVEL
+	}
+
+#if SPOT_SIMD_DISPATCH
+	namespace simd_avx2
+	{
+#		define SPOT_SIMD_ATTRIBUTES __attribute__(( target( "avx2,fma" ), flatten ))
+#		define SPOT_SIMD_VECTOR_BYTES 32
+#		define SPOT_SIMD_LEVEL simd_level::avx2
+#		include "simd_kernels.inl"
+#		undef SPOT_SIMD_ATTRIBUTES
+#		undef SPOT_SIMD_VECTOR_BYTES
+#		undef SPOT_SIMD_LEVEL
+	}
+
+	// all levels use the same blocking, so that sums are computed in the same order
+	namespace simd_avx512
+	{
+#		define SPOT_SIMD_ATTRIBUTES __attribute__(( target( "avx512f,avx2,fma" ), flatten ))
+#		define SPOT_SIMD_VECTOR_BYTES 32
+#		define SPOT_SIMD_LEVEL simd_level::avx512
+#		include "simd_kernels.inl"
+#		undef SPOT_SIMD_ATTRIBUTES
+#		undef SPOT_SIMD_VECTOR_BYTES
+#		undef SPOT_SIMD_LEVEL
+	}
+#endif
+
+	bool simd_supported( simd_level l )
+	{
+		switch ( l )
+		{
+		case simd_level::scalar: return true;
+#if SPOT_SIMD_DISPATCH
+		case simd_level::avx2: return __builtin_cpu_supports( "avx2" ) && __builtin_cpu_supports( "fma" );
+		case simd_level::avx512: return simd_supported( simd_level::avx2 ) && __builtin_cpu_supports( "avx512f" );
+#endif
+		default: return false;
+		}
+	}
+
+	const simd_kernels& simd_kernels_for( simd_level l )
+	{
+		xo_error_if( !simd_supported( l ), "SIMD level not supported: " + to_str( l ) );
+		switch ( l )
+		{
+#if SPOT_SIMD_DISPATCH
+		case simd_level::avx2: return simd_avx2::kernels();
+		case simd_level::avx512: return simd_avx512::kernels();
+#endif
+		default: return simd_scalar::kernels();
+		}
+	}
+
+	static simd_level select_simd_level()
+	{
+		auto best = simd_level::scalar;
+		for ( auto l : { simd_level::avx2, simd_level::avx512 } )
+			if ( simd_supported( l ) )
+				best = l;
+
+		// SPOT_SIMD can be used to test a specific path, it is clamped to what is supported
+		if ( auto* name = std::getenv( "SPOT_SIMD" ); name && *name )
+		{
+			for ( auto l : { simd_level::scalar, simd_level::avx2, simd_level::avx512 } )
+			{
+				if ( to_str( l ) == name )
+				{
+					if ( l > best )
+						xo::log::warning( "SPOT_SIMD=", name, " is not supported, using ", to_str( best ) );
+					return std::min( l, best );
+				}
+			}
+			xo::log::warning( "Invalid SPOT_SIMD value: ", name );
+		}
+		return best;
+	}
+
+	const simd_kernels& simd()
+	{
+		static const simd_kernels& kernels = simd_kernels_for( select_simd_level() );
+		return kernels;
+	}
+
+	string to_str( simd_level l )
+	{
+		switch ( l )
+		{
+		case simd_level::scalar: return "scalar";
+		case simd_level::avx2: return "avx2";
+		case simd_level::avx512: return "avx512";
+		default: return "unknown";
+		}
+	}
+}
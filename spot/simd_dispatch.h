@@ -0,0 +1,44 @@
+#pragma once
+
+#include "spot_types.h"
+
+namespace spot
+{
+	/// Instruction set used by the dense numeric kernels.
+	/// The scalar level is the portable baseline (SSE2 on x86-64), other levels are only available on x86 with GCC or Clang.
+	/// All levels produce bitwise identical results (same blocking, no fma contraction), so that runs are reproducible across machines.
+	enum class simd_level { scalar, avx2, avx512 };
+
+	/// Table of numeric kernels, compiled for a specific instruction set.
+	/// Matrices are nested vectors accessed as m[row][col], as used by cma_optimizer.
+	struct simd_kernels
+	{
+		simd_level level;
+
+		// boundary transformations of count points with n parameters, stored contiguously row by row
+		void( *boundary_transform )( size_t n, size_t count, par_t* x, const par_t* lb, const par_t* ub, const par_t* al, const par_t* au );
+		void( *boundary_transform_inverse )( size_t n, size_t count, par_t* x, const par_t* lb, const par_t* ub, const par_t* al, const par_t* au );
+		void( *reflective_transform )( size_t n, size_t count, par_t* x, const par_t* lb, const par_t* ub );
+
+		// number of values outside [lb, ub], clamp returns the number of clamped values
+		size_t( *count_out_of_bounds )( size_t n, const par_t* x, const par_t* lb, const par_t* ub );
+		size_t( *clamp )( size_t n, size_t count, par_t* x, const par_t* lb, const par_t* ub );
+
+		void( *transform_sample )( size_t n, const vector< vector< double > >& B, const double* d, const double* z, double* dz, double* y );
+		void( *transform_sample_float )( size_t n, const vector< vector< float > >& B, const float* d, const float* z, float* dz, float* y );
+		void( *update_covariance )( size_t n, vector< vector< double > >& C, double c_old, double c1, double cmu,
+			const double* pc, size_t mu, const double* weights, const vector< vector< double > >& y, bool diagonal );
+	};
+
+	/// Kernels for the best level supported by both the build and the cpu, selected on first use.
+	/// Set the SPOT_SIMD environment variable to scalar, avx2 or avx512 to use a specific level instead.
+	SPOT_API const simd_kernels& simd();
+
+	/// Kernels for a specific level, throws if the level is not supported.
+	SPOT_API const simd_kernels& simd_kernels_for( simd_level l );
+
+	/// Check if a level is compiled in and supported by the cpu.
+	SPOT_API bool simd_supported( simd_level l );
+
+	SPOT_API string to_str( simd_level l );
+}
@@ -0,0 +1,64 @@
+// Kernel definitions for a single simd_level, included once per level by simd_dispatch.cpp.
+// Expects SPOT_SIMD_ATTRIBUTES (function attributes selecting the instruction set) and SPOT_SIMD_VECTOR_BYTES.
+// The wrappers are flattened, so that the templates in cma_kernels.h are inlined and compiled for the target.
+
+SPOT_SIMD_ATTRIBUTES void boundary_transform( size_t n, size_t count, par_t* x, const par_t* lb, const par_t* ub, const par_t* al, const par_t* au ) {
+	cma_apply_rows< par_t, SPOT_SIMD_VECTOR_BYTES >( n, count, x,
+		[=]( par_t v, size_t i ) { return cmaes_boundary_transform( v, lb[i], ub[i], al[i], au[i] ); } );
+}
+
+SPOT_SIMD_ATTRIBUTES void boundary_transform_inverse( size_t n, size_t count, par_t* x, const par_t* lb, const par_t* ub, const par_t* al, const par_t* au ) {
+	cma_apply_rows< par_t, SPOT_SIMD_VECTOR_BYTES >( n, count, x,
+		[=]( par_t v, size_t i ) { return cmaes_boundary_transform_inverse( v, lb[i], ub[i], al[i], au[i] ); } );
+}
+
+SPOT_SIMD_ATTRIBUTES void reflective_transform( size_t n, size_t count, par_t* x, const par_t* lb, const par_t* ub ) {
+	cma_apply_rows< par_t, SPOT_SIMD_VECTOR_BYTES >( n, count, x,
+		[=]( par_t v, size_t i ) { return reflective_boundary_transform( v, lb[i], ub[i] ); } );
+}
+
+SPOT_SIMD_ATTRIBUTES size_t count_out_of_bounds( size_t n, const par_t* x, const par_t* lb, const par_t* ub ) {
+	constexpr size_t lanes = SPOT_SIMD_VECTOR_BYTES / sizeof( par_t );
+	par_t acc[lanes] = {};
+	size_t i = 0;
+	for ( ; i + lanes <= n; i += lanes )
+		for ( size_t l = 0; l < lanes; ++l )
+			acc[l] += ( x[i + l] < lb[i + l] ) | ( x[i + l] > ub[i + l] ) ? par_t( 1 ) : par_t( 0 );
+	size_t sum = 0;
+	for ( ; i < n; ++i )
+		sum += ( x[i] < lb[i] ) | ( x[i] > ub[i] );
+	for ( auto v : acc )
+		sum += size_t( v );
+	return sum;
+}
+
+SPOT_SIMD_ATTRIBUTES size_t clamp( size_t n, size_t count, par_t* x, const par_t* lb, const par_t* ub ) {
+	size_t clamped = 0;
+	for ( size_t k = 0; k < count; ++k, x += n )
+	{
+		clamped += count_out_of_bounds( n, x, lb, ub );
+		cma_apply_rows< par_t, SPOT_SIMD_VECTOR_BYTES >( n, 1, x,
+			[=]( par_t v, size_t i ) { return std::min( std::max( v, lb[i] ), ub[i] ); } );
+	}
+	return clamped;
+}
+
+SPOT_SIMD_ATTRIBUTES void transform_sample( size_t n, const vector< vector< double > >& B, const double* d, const double* z, double* dz, double* y ) {
+	cma_transform_sample< double, vector< vector< double > >, SPOT_SIMD_VECTOR_BYTES >( n, B, d, z, dz, y );
+}
+
+SPOT_SIMD_ATTRIBUTES void transform_sample_float( size_t n, const vector< vector< float > >& B, const float* d, const float* z, float* dz, float* y ) {
+	cma_transform_sample< float, vector< vector< float > >, SPOT_SIMD_VECTOR_BYTES >( n, B, d, z, dz, y );
+}
+
+SPOT_SIMD_ATTRIBUTES void update_covariance( size_t n, vector< vector< double > >& C, double c_old, double c1, double cmu,
+	const double* pc, size_t mu, const double* weights, const vector< vector< double > >& y, bool diagonal ) {
+	cma_update_covariance< double, vector< vector< double > >, vector< vector< double > >, SPOT_SIMD_VECTOR_BYTES >(
+		n, C, c_old, c1, cmu, pc, mu, weights, y, diagonal );
+}
+
+inline const simd_kernels& kernels() {
+	static const simd_kernels k{ SPOT_SIMD_LEVEL, boundary_transform, boundary_transform_inverse, reflective_transform, count_out_of_bounds, clamp,
+		transform_sample, transform_sample_float, update_covariance };
+	return k;
+}
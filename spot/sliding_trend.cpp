@@ -0,0 +1,124 @@
+#include "sliding_trend.h"
+
+#include "xo/system/assert.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace spot
+{
+	void sliding_median::insert( float v )
+	{
+		if ( lower_.empty() || v <= *lower_.rbegin() )
+			lower_.insert( v );
+		else upper_.insert( v );
+		rebalance();
+	}
+
+	void sliding_median::erase( float v )
+	{
+		// equal values are interchangeable, so it's fine to erase from lower_ first
+		if ( !lower_.empty() && v <= *lower_.rbegin() )
+		{
+			auto it = lower_.find( v );
+			xo_assert( it != lower_.end() );
+			lower_.erase( it );
+		}
+		else
+		{
+			auto it = upper_.find( v );
+			xo_assert( it != upper_.end() );
+			upper_.erase( it );
+		}
+		rebalance();
+	}
+
+	float sliding_median::median() const
+	{
+		xo_assert( !lower_.empty() );
+		if ( lower_.size() > upper_.size() )
+			return *lower_.rbegin();
+		else return 0.5f * ( *lower_.rbegin() + *upper_.begin() );
+	}
+
+	void sliding_median::rebalance()
+	{
+		while ( lower_.size() > upper_.size() + 1 )
+		{
+			upper_.insert( *lower_.rbegin() );
+			lower_.erase( std::prev( lower_.end() ) );
+		}
+		while ( upper_.size() > lower_.size() )
+		{
+			lower_.insert( *upper_.begin() );
+			upper_.erase( upper_.begin() );
+		}
+	}
+
+	void sliding_trend::set_window_size( size_t window_size )
+	{
+		window_size_ = window_size;
+		lag_ = std::max<size_t>( 1, window_size / 2 );
+		clear();
+	}
+
+	void sliding_trend::clear()
+	{
+		samples_ = 0;
+		values_.clear();
+		value_median_.clear();
+		slope_median_.clear();
+	}
+
+	void sliding_trend::push_back( float y )
+	{
+		if ( window_size_ == 0 )
+			return;
+
+		// NaN cannot be ordered in the medians, infinite values would produce NaN differences
+		if ( std::isnan( y ) )
+			return;
+		y = std::clamp( y, std::numeric_limits<float>::lowest(), std::numeric_limits<float>::max() );
+
+		if ( values_.size() == window_size_ )
+		{
+			if ( values_.size() > lag_ )
+				slope_median_.erase( lag_difference( 0 ) );
+			value_median_.erase( values_.front() );
+			values_.pop_front();
+		}
+
+		values_.push_back( y );
+		value_median_.insert( y );
+		if ( values_.size() > lag_ )
+			slope_median_.insert( lag_difference( values_.size() - 1 - lag_ ) );
+		++samples_;
+	}
+
+	xo::linear_function< float > sliding_trend::trend() const
+	{
+		auto n = values_.size();
+		if ( n < 2 )
+			return xo::linear_function< float >();
+
+		float slope;
+		if ( n == window_size_ )
+			slope = slope_median_.median();
+		else
+		{
+			// window not yet filled, use differences over half of the available samples, O(n)
+			auto k = n / 2;
+			vector< float > diffs;
+			for ( index_t i = 0; i + k < n; ++i )
+				diffs.push_back( ( values_[i + k] - values_[i] ) / k );
+			auto mid = diffs.begin() + diffs.size() / 2;
+			std::nth_element( diffs.begin(), mid, diffs.end() );
+			slope = *mid;
+			if ( diffs.size() % 2 == 0 )
+				slope = 0.5f * ( slope + *std::max_element( diffs.begin(), mid ) );
+		}
+
+		auto center = float( samples_ - n ) + 0.5f * float( n - 1 );
+		return xo::linear_function< float >( value_median_.median() - slope * center, slope );
+	}
+}
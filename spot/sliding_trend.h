@@ -0,0 +1,56 @@
+#pragma once
+
+#include "spot_types.h"
+#include "xo/numerical/polynomial.h"
+#include <deque>
+#include <set>
+
+namespace spot
+{
+	/// Median of a changing set of values, with O(log n) insert and erase.
+	class SPOT_API sliding_median
+	{
+	public:
+		void insert( float v );
+		void erase( float v );
+		float median() const;
+		size_t size() const { return lower_.size() + upper_.size(); }
+		void clear() { lower_.clear(); upper_.clear(); }
+
+	private:
+		void rebalance();
+		std::multiset< float > lower_; // smallest half, contains the median for odd sizes
+		std::multiset< float > upper_;
+	};
+
+	/// Robust linear trend of the most recent samples, updated in O(log n) per sample.
+	/// The slope is the median difference between samples half a window apart,
+	/// the line passes through the median sample value at the center of the window.
+	/// Unlike repeated median regression, the offset is biased by outliers that are all on one side.
+	class SPOT_API sliding_trend
+	{
+	public:
+		sliding_trend( size_t window_size = 0 ) { set_window_size( window_size ); }
+
+		void set_window_size( size_t window_size );
+		size_t window_size() const { return window_size_; }
+		void clear();
+
+		/// Add a sample, its x value is the number of samples added before. NaN samples are ignored.
+		void push_back( float y );
+		xo::linear_function< float > trend() const;
+
+		size_t size() const { return values_.size(); }
+		size_t samples() const { return samples_; }
+
+	private:
+		float lag_difference( index_t i ) const { return ( values_[i + lag_] - values_[i] ) / lag_; }
+
+		size_t window_size_;
+		size_t lag_;
+		size_t samples_;
+		std::deque< float > values_;
+		sliding_median value_median_;
+		sliding_median slope_median_;
+	};
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 //#define SPOT_PRECISION_SINGLE
+//#define SPOT_TRACE_ENABLED
 
 #if defined( SPOT_PRECISION_SINGLE )
 #	define SPOT_DEFAULT_PRECISION_TYPE float
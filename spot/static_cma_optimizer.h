@@ -0,0 +1,374 @@
+#pragma once
+
+#include "optimizer.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+
+namespace spot
+{
+	/// Natural logarithm that can be evaluated at compile time.
+	constexpr double constexpr_log( double x ) {
+		int k = 0;
+		for ( ; x > 2.0; x /= 2.0 ) ++k;
+		for ( ; x < 1.0; x *= 2.0 ) --k;
+		double y = ( x - 1.0 ) / ( x + 1.0 ), y2 = y * y, term = y, sum = 0.0;
+		for ( int n = 1; n < 64; n += 2, term *= y2 )
+			sum += term / n;
+		return 2.0 * sum + k * 0.69314718055994530942;
+	}
+
+	/// Default population size of CMA-ES, same as cma_optimizer.
+	constexpr int static_cma_default_lambda( int n ) { return 4 + int( 3.0 * constexpr_log( double( n ) ) ); }
+
+	/// Symmetric eigendecomposition A = B * diag( d ) * B^T through cyclic Jacobi rotations.
+	/// All loop bounds are known at compile time, so that small problems are fully unrolled.
+	template< int N >
+	void static_symmetric_eigen( std::array< std::array< double, N >, N > a, std::array< double, N >& d, std::array< std::array< double, N >, N >& b ) {
+		for ( int i = 0; i < N; ++i )
+			for ( int j = 0; j < N; ++j )
+				b[i][j] = i == j ? 1.0 : 0.0;
+
+		for ( int sweep = 0; sweep < 50; ++sweep )
+		{
+			double off = 0.0, diag = 0.0;
+			for ( int i = 0; i < N; ++i )
+			{
+				diag += a[i][i] * a[i][i];
+				for ( int j = i + 1; j < N; ++j )
+					off += a[i][j] * a[i][j];
+			}
+			if ( off <= 1e-30 * diag )
+				break;
+
+			for ( int p = 0; p < N; ++p )
+			{
+				for ( int q = p + 1; q < N; ++q )
+				{
+					if ( a[p][q] == 0.0 )
+						continue;
+					const double theta = ( a[q][q] - a[p][p] ) / ( 2.0 * a[p][q] );
+					const double t = ( theta >= 0 ? 1.0 : -1.0 ) / ( std::abs( theta ) + std::sqrt( theta * theta + 1.0 ) );
+					const double c = 1.0 / std::sqrt( t * t + 1.0 ), s = t * c;
+					for ( int k = 0; k < N; ++k )
+					{
+						const double akp = a[k][p], akq = a[k][q];
+						a[k][p] = c * akp - s * akq;
+						a[k][q] = s * akp + c * akq;
+					}
+					for ( int k = 0; k < N; ++k )
+					{
+						const double apk = a[p][k], aqk = a[q][k];
+						a[p][k] = c * apk - s * aqk;
+						a[q][k] = s * apk + c * aqk;
+					}
+					for ( int k = 0; k < N; ++k )
+					{
+						const double bkp = b[k][p], bkq = b[k][q];
+						b[k][p] = c * bkp - s * bkq;
+						b[k][q] = s * bkp + c * bkq;
+					}
+				}
+			}
+		}
+
+		for ( int i = 0; i < N; ++i )
+			d[i] = a[i][i];
+	}
+
+	/// CMA-ES with dimension and population size known at compile time, for small problems that are solved often.
+	/// All state is stored in fixed-size arrays, no memory is allocated after construction. Strategy parameters are
+	/// the same as cma_optimizer, and are computed once per instantiation. Fitness is always minimized.
+	template< int N, int Lambda = static_cma_default_lambda( N ) >
+	class static_cma_optimizer
+	{
+	public:
+		static_assert( N > 0 && Lambda >= 2 );
+		static constexpr int dim = N;
+		static constexpr int lambda = Lambda;
+		static constexpr int mu = Lambda / 2;
+
+		using vec_t = std::array< double, N >;
+		using mat_t = std::array< vec_t, N >;
+		using population_t = std::array< vec_t, Lambda >;
+		using fitness_array_t = std::array< double, Lambda >;
+
+		struct strategy_parameters {
+			std::array< double, mu > weights;
+			double mueff, cs, ccumcov, ccov1, ccovmu, damps, chiN, eigen_modulo;
+		};
+
+		/// Strategy parameters, computed once since std::log and std::sqrt are not constexpr.
+		static const strategy_parameters& params() {
+			static const strategy_parameters p = make_strategy_parameters();
+			return p;
+		}
+
+		static_cma_optimizer( const vec_t& mean, const vec_t& std, unsigned long long random_seed = 123 ) :
+			mean_( mean ),
+			random_engine_( random_seed )
+		{
+			lower_.fill( -std::numeric_limits< double >::infinity() );
+			upper_.fill( std::numeric_limits< double >::infinity() );
+			double trace = 0;
+			for ( auto s : std )
+				trace += s * s;
+			sigma_ = std::sqrt( trace / N );
+			for ( int i = 0; i < N; ++i )
+			{
+				for ( int j = 0; j < N; ++j )
+					C_[i][j] = B_[i][j] = 0.0;
+				D_[i] = std[i] * std::sqrt( N / trace );
+				C_[i][i] = D_[i] * D_[i];
+				B_[i][i] = 1.0;
+			}
+			pc_.fill( 0.0 );
+			ps_.fill( 0.0 );
+		}
+
+		/// Samples outside the bounds are resampled, and clamped if no feasible sample is found.
+		void set_bounds( const vec_t& lower, const vec_t& upper ) { lower_ = lower; upper_ = upper; }
+
+		const population_t& sample_population() {
+			for ( auto& x : population_ )
+			{
+				for ( int attempt = 0; attempt < max_resample_count; ++attempt )
+				{
+					sample( x );
+					if ( is_feasible( x ) )
+						break;
+				}
+				for ( int i = 0; i < N; ++i )
+					x[i] = std::clamp( x[i], lower_[i], upper_[i] );
+			}
+			return population_;
+		}
+
+		void update_distribution( const fitness_array_t& fitnesses ) {
+			const auto& p = params();
+			std::array< int, Lambda > index;
+			std::iota( index.begin(), index.end(), 0 );
+			std::sort( index.begin(), index.end(), [&]( int a, int b ) { return fitnesses[a] < fitnesses[b]; } );
+			++generation_;
+
+			if ( fitnesses[index[0]] < best_fitness_ )
+			{
+				best_fitness_ = fitnesses[index[0]];
+				best_point_ = population_[index[0]];
+			}
+
+			// escape flat fitness
+			if ( fitnesses[index[0]] == fitnesses[index[Lambda / 2]] )
+				sigma_ *= std::exp( 0.2 + p.cs / p.damps );
+
+			// new mean and BDz ~ N(0,C)
+			const vec_t old_mean = mean_;
+			vec_t bdz, z;
+			for ( int i = 0; i < N; ++i )
+			{
+				mean_[i] = 0.0;
+				for ( int k = 0; k < mu; ++k )
+					mean_[i] += p.weights[k] * population_[index[k]][i];
+				bdz[i] = std::sqrt( p.mueff ) * ( mean_[i] - old_mean[i] ) / sigma_;
+			}
+
+			// z = D^-1 * B^T * BDz
+			for ( int i = 0; i < N; ++i )
+			{
+				double sum = 0.0;
+				for ( int j = 0; j < N; ++j )
+					sum += B_[j][i] * bdz[j];
+				z[i] = sum / D_[i];
+			}
+
+			// cumulation for sigma using B * z
+			double psxps = 0.0;
+			for ( int i = 0; i < N; ++i )
+			{
+				double sum = 0.0;
+				for ( int j = 0; j < N; ++j )
+					sum += B_[i][j] * z[j];
+				ps_[i] = ( 1.0 - p.cs ) * ps_[i] + std::sqrt( p.cs * ( 2.0 - p.cs ) ) * sum;
+				psxps += ps_[i] * ps_[i];
+			}
+
+			// cumulation for covariance matrix
+			const bool hsig = std::sqrt( psxps ) / std::sqrt( 1.0 - std::pow( 1.0 - p.cs, 2.0 * generation_ ) ) / p.chiN < 1.4 + 2.0 / ( N + 1.0 );
+			for ( int i = 0; i < N; ++i )
+				pc_[i] = ( 1.0 - p.ccumcov ) * pc_[i] + ( hsig ? std::sqrt( p.ccumcov * ( 2.0 - p.ccumcov ) ) : 0.0 ) * bdz[i];
+
+			// rank one and rank mu update of C
+			const double sigma_sq = sigma_ * sigma_;
+			const double c_hsig = hsig ? 0.0 : p.ccumcov * ( 2.0 - p.ccumcov );
+			for ( int i = 0; i < N; ++i )
+			{
+				for ( int j = 0; j <= i; ++j )
+				{
+					double c = ( 1.0 - p.ccov1 - p.ccovmu ) * C_[i][j] + p.ccov1 * ( pc_[i] * pc_[j] + c_hsig * C_[i][j] );
+					for ( int k = 0; k < mu; ++k )
+						c += p.ccovmu * p.weights[k] * ( population_[index[k]][i] - old_mean[i] ) * ( population_[index[k]][j] - old_mean[j] ) / sigma_sq;
+					C_[i][j] = C_[j][i] = c;
+				}
+			}
+
+			sigma_ *= std::exp( ( std::sqrt( psxps ) / p.chiN - 1.0 ) * p.cs / p.damps );
+
+			if ( generation_ >= eigen_generation_ + p.eigen_modulo )
+				update_eigensystem();
+		}
+
+		/// Perform a single generation using a callable f( const vec_t& ) -> double, returns the best fitness of the generation.
+		template< typename F > double step( F&& f ) {
+			const auto& pop = sample_population();
+			fitness_array_t fitnesses;
+			for ( int k = 0; k < Lambda; ++k )
+				fitnesses[k] = f( pop[k] );
+			update_distribution( fitnesses );
+			return *std::min_element( fitnesses.begin(), fitnesses.end() );
+		}
+
+		/// Run until max_generations is reached, or until sigma drops below min_sigma.
+		template< typename F > double run( F&& f, size_t max_generations, double min_sigma = 1e-12 ) {
+			for ( size_t g = 0; g < max_generations && sigma_ > min_sigma; ++g )
+				step( f );
+			return best_fitness_;
+		}
+
+		size_t generation() const { return generation_; }
+		double sigma() const { return sigma_; }
+		const vec_t& mean() const { return mean_; }
+		const mat_t& covariance() const { return C_; }
+		const population_t& population() const { return population_; }
+		const vec_t& best_point() const { return best_point_; }
+		double best_fitness() const { return best_fitness_; }
+
+		static constexpr int max_resample_count = 100;
+
+	private:
+		static strategy_parameters make_strategy_parameters() {
+			strategy_parameters p{};
+			double s1 = 0, s2 = 0;
+			for ( int i = 0; i < mu; ++i )
+			{
+				p.weights[i] = std::log( mu + 1.0 ) - std::log( i + 1.0 );
+				s1 += p.weights[i];
+				s2 += p.weights[i] * p.weights[i];
+			}
+			for ( auto& w : p.weights )
+				w /= s1;
+			p.mueff = s1 * s1 / s2;
+			p.cs = ( p.mueff + 2.0 ) / ( N + p.mueff + 3.0 );
+			p.ccumcov = 4.0 / ( N + 4.0 );
+			const double t1 = 2.0 / ( ( N + 1.4142 ) * ( N + 1.4142 ) );
+			const double t2 = std::min( 1.0, ( 2.0 * p.mueff - 1.0 ) / ( ( N + 2.0 ) * ( N + 2.0 ) + p.mueff ) );
+			const double ccov = ( 1.0 / p.mueff ) * t1 + ( 1.0 - 1.0 / p.mueff ) * t2;
+			p.ccov1 = std::min( ccov / p.mueff, 1.0 );
+			p.ccovmu = std::min( ccov * ( 1.0 - 1.0 / p.mueff ), 1.0 - p.ccov1 );
+			const double max_evals = 900.0 * ( N + 3.0 ) * ( N + 3.0 );
+			p.damps = ( 1.0 + 2.0 * std::max( 0.0, std::sqrt( ( p.mueff - 1.0 ) / ( N + 1.0 ) ) - 1.0 ) )
+				* std::max( 0.3, 1.0 - N / ( 1e-6 + std::ceil( max_evals / Lambda ) ) ) + p.cs;
+			p.chiN = std::sqrt( double( N ) ) * ( 1.0 - 1.0 / ( 4.0 * N ) + 1.0 / ( 21.0 * N * N ) );
+			p.eigen_modulo = 1.0 / ccov / N / 10.0;
+			return p;
+		}
+
+		void sample( vec_t& x ) {
+			vec_t dz;
+			for ( int i = 0; i < N; ++i )
+				dz[i] = D_[i] * normal_( random_engine_ );
+			for ( int i = 0; i < N; ++i )
+			{
+				double sum = 0.0;
+				for ( int j = 0; j < N; ++j )
+					sum += B_[i][j] * dz[j];
+				x[i] = mean_[i] + sigma_ * sum;
+			}
+		}
+
+		bool is_feasible( const vec_t& x ) const {
+			for ( int i = 0; i < N; ++i )
+				if ( x[i] < lower_[i] || x[i] > upper_[i] )
+					return false;
+			return true;
+		}
+
+		void update_eigensystem() {
+			static_symmetric_eigen< N >( C_, D_, B_ );
+			for ( auto& d : D_ )
+				d = std::sqrt( std::max( d, 0.0 ) );
+			eigen_generation_ = generation_;
+		}
+
+		vec_t mean_;
+		double sigma_;
+		mat_t C_, B_;
+		vec_t D_, pc_, ps_;
+		vec_t lower_, upper_;
+		population_t population_;
+		size_t generation_ = 0;
+		size_t eigen_generation_ = 0;
+		vec_t best_point_{};
+		double best_fitness_ = std::numeric_limits< double >::infinity();
+		std::mt19937_64 random_engine_;
+		std::normal_distribution< double > normal_;
+	};
+
+	/// Runs a static_cma_optimizer through the optimizer interface, so that it can be used with evaluators,
+	/// reporters and stop conditions. The dimension of the objective must be N.
+	template< int N, int Lambda = static_cma_default_lambda( N ) >
+	class static_cma_adapter : public optimizer
+	{
+	public:
+		using cma_t = static_cma_optimizer< N, Lambda >;
+
+		static_cma_adapter( const objective& o, evaluator& e, unsigned long long random_seed = 123 ) :
+			optimizer( o, e ),
+			cma_( make_cma( o, random_seed ) ),
+			population_( Lambda, search_point( o.info() ) )
+		{
+			name = o.name() + xo::stringf( ".S%llu", random_seed );
+			add_stop_condition( std::make_unique< flat_fitness_condition >( 1e-9 ) );
+		}
+
+		const cma_t& cma() const { return cma_; }
+
+	protected:
+		virtual bool internal_step() override {
+			const auto& pop = cma_.sample_population();
+			for ( int k = 0; k < Lambda; ++k )
+				population_[k].set_values( par_vec( pop[k].begin(), pop[k].end() ) );
+			if ( evaluate_step( population_ ) )
+			{
+				typename cma_t::fitness_array_t fitnesses;
+				for ( int k = 0; k < Lambda; ++k )
+					fitnesses[k] = info().minimize() ? current_step_fitnesses_[k] : -current_step_fitnesses_[k];
+				cma_.update_distribution( fitnesses );
+				return true;
+			}
+			return false;
+		}
+
+	private:
+		static cma_t make_cma( const objective& o, unsigned long long random_seed ) {
+			xo_error_if( o.dim() != N, xo::stringf( "Objective dimension %zu does not match %d", o.dim(), N ) );
+			typename cma_t::vec_t mean, std, lower, upper;
+			for ( int i = 0; i < N; ++i )
+			{
+				const auto& p = o.info()[i];
+				mean[i] = p.mean;
+				std[i] = p.std;
+				lower[i] = p.min;
+				upper[i] = p.max;
+			}
+			cma_t cma( mean, std, random_seed );
+			cma.set_bounds( lower, upper );
+			return cma;
+		}
+
+		cma_t cma_;
+		search_point_vec population_;
+	};
+}
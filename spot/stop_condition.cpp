@@ -32,6 +32,11 @@ namespace spot
 		return opt.current_step() >= max_steps_;
 	}
 
+	bool max_evaluations_condition::test( const optimizer& opt )
+	{
+		return opt.evaluation_count() >= max_evaluations_;
+	}
+
 	bool min_progress_condition::test( const optimizer& opt )
 	{
 		if ( opt.current_step() >= min_samples_ )
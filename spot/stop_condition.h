@@ -55,6 +55,14 @@ namespace spot
 		size_t max_steps_;
 	};
 
+	struct SPOT_API max_evaluations_condition : public stop_condition
+	{
+		max_evaluations_condition( size_t evaluations ) : max_evaluations_( evaluations ) {}
+		virtual string what() const override { return "Maximum number of evaluations reached"; }
+		virtual bool test( const optimizer& opt ) override;
+		size_t max_evaluations_;
+	};
+
 	struct SPOT_API min_progress_condition : public stop_condition
 	{
 		min_progress_condition( fitness_t progress, size_t min_samples = 200 ) : min_progress_( progress ), min_samples_( min_samples ) {}
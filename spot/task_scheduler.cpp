@@ -0,0 +1,26 @@
+#include "task_scheduler.h"
+
+#include <algorithm>
+
+namespace spot
+{
+	static thread_local task_scheduler* t_current_scheduler = nullptr;
+
+	task_scheduler& task_scheduler::current()
+	{
+		static sequential_scheduler s_sequential_scheduler;
+		return t_current_scheduler ? *t_current_scheduler : s_sequential_scheduler;
+	}
+
+	void task_scheduler::set_current( task_scheduler* s )
+	{
+		t_current_scheduler = s;
+	}
+
+	void sequential_scheduler::parallel_for( size_t n, size_t grain_size, const range_function& body )
+	{
+		grain_size = std::max< size_t >( 1, grain_size );
+		for ( size_t begin = 0; begin < n; begin += grain_size )
+			body( begin, std::min( begin + grain_size, n ) );
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "spot_types.h"
+#include <algorithm>
+#include <functional>
+
+namespace spot
+{
+	/// Runs ranges of work in parallel on behalf of an objective, for parallelism within a single evaluation.
+	class SPOT_API task_scheduler
+	{
+	public:
+		using range_function = std::function< void( size_t begin, size_t end ) >;
+
+		virtual ~task_scheduler() = default;
+
+		/// Call body for consecutive ranges of at most grain_size elements in [0, n) and return when all are done.
+		/// Ranges may run in parallel; the calling thread also runs ranges, so this never waits for busy workers.
+		virtual void parallel_for( size_t n, size_t grain_size, const range_function& body ) = 0;
+
+		/// Reduce the results of map( begin, end ) for each range, in range order so the result does not depend on scheduling.
+		template< typename T, typename MapF, typename ReduceF >
+		T parallel_reduce( size_t n, size_t grain_size, T init, MapF map, ReduceF reduce ) {
+			grain_size = std::max< size_t >( 1, grain_size );
+			vector< T > partials( ( n + grain_size - 1 ) / grain_size, init );
+			parallel_for( n, grain_size, [&]( size_t begin, size_t end ) { partials[begin / grain_size] = map( begin, end ); } );
+			for ( const auto& p : partials )
+				init = reduce( init, p );
+			return init;
+		}
+
+		/// Scheduler offered by the evaluator that runs the current thread, or a sequential scheduler.
+		static task_scheduler& current();
+
+		/// Set the scheduler of the current thread, nullptr resets it to the sequential scheduler.
+		static void set_current( task_scheduler* s );
+	};
+
+	/// Scheduler that runs all ranges in the calling thread.
+	class SPOT_API sequential_scheduler : public task_scheduler
+	{
+	public:
+		virtual void parallel_for( size_t n, size_t grain_size, const range_function& body ) override;
+	};
+}
@@ -0,0 +1,124 @@
+#include "tracer.h"
+
+#include "xo/system/assert.h"
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+namespace spot
+{
+	struct trace_span
+	{
+		const char* name;
+		tracer::clock::time_point begin;
+		tracer::clock::time_point end;
+	};
+
+	// spans of a single thread, the mutex is only contended during export
+	struct trace_buffer
+	{
+		std::mutex mutex;
+		vector< trace_span > spans;
+		size_t thread_id;
+	};
+
+	struct trace_registry
+	{
+		std::atomic_bool active = false;
+		tracer::clock::time_point epoch = tracer::clock::now();
+		std::mutex mutex;
+		vector< std::shared_ptr< trace_buffer > > buffers; // buffers are kept after their thread ends
+	};
+
+	static trace_registry& get_registry()
+	{
+		static trace_registry registry;
+		return registry;
+	}
+
+	static trace_buffer& get_thread_buffer()
+	{
+		thread_local std::shared_ptr< trace_buffer > buffer = []() {
+			auto& reg = get_registry();
+			std::scoped_lock lock( reg.mutex );
+			auto b = std::make_shared< trace_buffer >();
+			b->thread_id = reg.buffers.size() + 1;
+			reg.buffers.push_back( b );
+			return b;
+		}();
+		return *buffer;
+	}
+
+	void tracer::start()
+	{
+		get_registry().active = true;
+	}
+
+	void tracer::stop()
+	{
+		get_registry().active = false;
+	}
+
+	bool tracer::is_active()
+	{
+		return get_registry().active.load( std::memory_order_relaxed );
+	}
+
+	void tracer::clear()
+	{
+		auto& reg = get_registry();
+		std::scoped_lock lock( reg.mutex );
+		for ( auto& b : reg.buffers )
+		{
+			std::scoped_lock buffer_lock( b->mutex );
+			b->spans.clear();
+		}
+	}
+
+	size_t tracer::span_count()
+	{
+		auto& reg = get_registry();
+		std::scoped_lock lock( reg.mutex );
+		size_t count = 0;
+		for ( auto& b : reg.buffers )
+		{
+			std::scoped_lock buffer_lock( b->mutex );
+			count += b->spans.size();
+		}
+		return count;
+	}
+
+	void tracer::add_span( const char* name, clock::time_point begin, clock::time_point end )
+	{
+		auto& buffer = get_thread_buffer();
+		std::scoped_lock lock( buffer.mutex );
+		buffer.spans.push_back( trace_span{ name, begin, end } );
+	}
+
+	void tracer::write_chrome_trace( const path& filename )
+	{
+		std::ofstream str( filename.str() );
+		xo_error_if( !str.good(), "Could not open " + filename.str() );
+		str.setf( std::ios::fixed );
+		str.precision( 3 );
+
+		// complete events ("ph":"X") with timestamps in microseconds
+		auto& reg = get_registry();
+		auto to_us = [&]( clock::duration d ) { return std::chrono::duration< double, std::micro >( d ).count(); };
+		std::scoped_lock lock( reg.mutex );
+		str << "{\"traceEvents\":[";
+		bool first = true;
+		for ( auto& b : reg.buffers )
+		{
+			std::scoped_lock buffer_lock( b->mutex );
+			for ( auto& s : b->spans )
+			{
+				str << ( first ? "\n" : ",\n" ) << "{\"name\":\"" << s.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << b->thread_id
+					<< ",\"ts\":" << to_us( s.begin - reg.epoch ) << ",\"dur\":" << to_us( s.end - s.begin ) << "}";
+				first = false;
+			}
+		}
+		str << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	}
+}
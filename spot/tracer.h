@@ -0,0 +1,56 @@
+#pragma once
+
+#include "spot_types.h"
+#include "xo/filesystem/path.h"
+#include <chrono>
+
+namespace spot
+{
+	/// Records spans of optimizer and evaluator activity in per-thread buffers, for export as Chrome trace events.
+	/// Spans are only recorded if SPOT_TRACE_ENABLED is defined and the tracer is started.
+	class SPOT_API tracer
+	{
+	public:
+		using clock = std::chrono::steady_clock;
+
+		static void start();
+		static void stop();
+		static bool is_active();
+
+		/// Remove all recorded spans.
+		static void clear();
+		static size_t span_count();
+
+		/// Write all recorded spans as Chrome trace event JSON, which can be viewed in chrome://tracing or Perfetto.
+		static void write_chrome_trace( const path& filename );
+
+		/// Record a span for the current thread, name must remain valid until the spans are cleared.
+		static void add_span( const char* name, clock::time_point begin, clock::time_point end );
+	};
+
+	/// Records a span from construction to destruction, if the tracer is active.
+	class trace_scope
+	{
+	public:
+		trace_scope( const char* name ) : name_( tracer::is_active() ? name : nullptr ) {
+			if ( name_ )
+				begin_ = tracer::clock::now();
+		}
+		~trace_scope() {
+			if ( name_ )
+				tracer::add_span( name_, begin_, tracer::clock::now() );
+		}
+
+	private:
+		const char* name_;
+		tracer::clock::time_point begin_;
+	};
+}
+
+#if defined( SPOT_TRACE_ENABLED )
+#	define SPOT_TRACE_CONCAT_IMPL( a, b ) a##b
+#	define SPOT_TRACE_CONCAT( a, b ) SPOT_TRACE_CONCAT_IMPL( a, b )
+#	define SPOT_TRACE_SCOPE( name ) ::spot::trace_scope SPOT_TRACE_CONCAT( spot_trace_scope_, __LINE__ )( name )
+#else
+#	define SPOT_TRACE_SCOPE( name )
+#endif
@@ -0,0 +1,114 @@
+#include "xo/system/test_case.h"
+
+#include "spot/async_reporter.h"
+#include "spot/cma_optimizer.h"
+#include "spot/test_objectives.h"
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+
+namespace spot
+{
+	struct recording_reporter : public reporter
+	{
+		recording_reporter( std::chrono::microseconds delay = {} ) : delay_( delay ) {}
+
+		virtual void on_start( const optimizer& opt ) override { started_ = true; }
+		virtual void on_stop( const optimizer& opt, const stop_condition& s ) override { stopped_ = true; }
+		virtual void on_new_best( const optimizer& opt, const search_point& point, fitness_t fitness ) override {
+			best_fitnesses_.push_back( fitness );
+			info_ok_ = info_ok_ && opt.make_updated_objective_info().dim() == point.dim();
+		}
+		virtual void on_post_step( const optimizer& opt ) override {
+			std::this_thread::sleep_for( delay_ );
+			steps_.push_back( opt.current_step() );
+			if ( opt.fitness_tracking_window_size() > 0 )
+				trends_.push_back( opt.fitness_trend()( float( opt.current_step() ) ) );
+			best_ok_ = best_ok_ && opt.best_fitness() <= opt.current_step_best_fitness();
+		}
+
+		std::chrono::microseconds delay_;
+		bool started_ = false;
+		bool stopped_ = false;
+		bool info_ok_ = true;
+		bool best_ok_ = true;
+		vector< index_t > steps_;
+		fitness_vec best_fitnesses_;
+		vector< float > trends_;
+	};
+
+	// blocks the reporter thread in on_pre_step until it is opened
+	struct gate_reporter : public reporter
+	{
+		virtual void on_pre_step( const optimizer& opt ) override {
+			std::unique_lock lock( mutex_ );
+			blocked_ = true;
+			cv_.notify_all();
+			cv_.wait( lock, [&]() { return open_; } );
+		}
+		void wait_until_blocked() {
+			std::unique_lock lock( mutex_ );
+			cv_.wait( lock, [&]() { return blocked_; } );
+		}
+		void open() {
+			std::scoped_lock lock( mutex_ );
+			open_ = true;
+			cv_.notify_all();
+		}
+
+		std::mutex mutex_;
+		std::condition_variable cv_;
+		bool blocked_ = false;
+		bool open_ = false;
+	};
+
+	XO_TEST_CASE( async_reporter_test )
+	{
+		auto obj = make_rosenbrock_objective( 4 );
+		sequential_evaluator eval;
+
+		// blocking, all events arrive in order with the state of the optimizer at that time
+		{
+			cma_optimizer cma( obj, eval, cma_options{ 0, 1 } );
+			cma.add_stop_condition( std::make_unique< max_steps_condition >( 100 ) );
+			cma.set_fitness_tracking_window_size( 20 );
+			auto& ar = static_cast< async_reporter& >( cma.add_reporter( std::make_unique< async_reporter >( 4 ) ) );
+			auto& rec = static_cast< recording_reporter& >( ar.add_reporter( std::make_unique< recording_reporter >( std::chrono::microseconds( 100 ) ) ) );
+			auto& sync_rec = static_cast< recording_reporter& >( cma.add_reporter( std::make_unique< recording_reporter >() ) );
+			cma.run();
+
+			XO_CHECK( rec.started_ && rec.stopped_ );
+			XO_CHECK( ar.dropped_events() == 0 );
+			XO_CHECK( rec.steps_.size() == 100 );
+			for ( index_t i = 0; i < rec.steps_.size(); ++i )
+				XO_CHECK( rec.steps_[i] == i );
+			XO_CHECK( !rec.best_fitnesses_.empty() && rec.best_fitnesses_.back() == cma.best_fitness() );
+			XO_CHECK( rec.info_ok_ && rec.best_ok_ );
+			XO_CHECK( rec.trends_.size() == 100 && rec.trends_ == sync_rec.trends_ ); // computed from the copied history
+		}
+
+		// dropping, events that don't fit in the queue are discarded while the reporter thread is blocked
+		{
+			cma_optimizer cma( obj, eval, cma_options{ 0, 1 } );
+			async_reporter ar( 2, async_overflow_policy::drop );
+			auto& gate = static_cast< gate_reporter& >( ar.add_reporter( std::make_unique< gate_reporter >() ) );
+			auto& rec = static_cast< recording_reporter& >( ar.add_reporter( std::make_unique< recording_reporter >() ) );
+			ar.on_pre_step( cma );
+			gate.wait_until_blocked();
+
+			// one slot is held by the blocked event, one is free
+			cma.step();
+			ar.on_post_step( cma );
+			for ( int i = 0; i < 10; ++i )
+			{
+				cma.step();
+				ar.on_post_step( cma );
+			}
+			XO_CHECK( ar.dropped_events() == 10 );
+
+			gate.open();
+			ar.flush();
+			XO_CHECK( rec.steps_.size() == 1 && rec.steps_.front() == 1 );
+		}
+	}
+}
@@ -0,0 +1,50 @@
+#include "xo/system/test_case.h"
+
+#include "spot/binary_history.h"
+#include "spot/file_reporter.h"
+#include "spot/cma_optimizer.h"
+#include "spot/test_objectives.h"
+#include <filesystem>
+
+namespace spot
+{
+	XO_TEST_CASE( binary_history_test )
+	{
+		auto folder = std::filesystem::temp_directory_path() / "spot_binary_history_test";
+		std::filesystem::create_directories( folder );
+		auto filename = path( ( folder / "test.bin" ).string() );
+
+		{
+			binary_history_writer w( filename, { "a", "bb", "ccc" } );
+			for ( int i = 0; i < 10000; ++i )
+				w.write_row( { double( i ), 2.0 * i, -0.5 * i } );
+		}
+		std::ofstream( filename.str(), std::ios::app | std::ios::binary ) << "partial row";
+
+		binary_history_reader r( filename );
+		XO_CHECK( r.labels() == vector< string >( { "a", "bb", "ccc" } ) );
+		XO_CHECK( r.rows() == 10000 );
+		auto bb = r.column( "bb" );
+		XO_CHECK( bb.size() == 10000 && bb[0] == 0.0 && bb[9999] == 19998.0 );
+		XO_CHECK( r.row( 1234 ) == vector< double >( { 1234.0, 2468.0, -617.0 } ) );
+		XO_CHECK( r.find_column( "d" ) == no_index );
+
+		// binary output of file_reporter
+		auto obj = make_rosenbrock_objective( 3 );
+		sequential_evaluator eval;
+		{
+			cma_optimizer cma( obj, eval, cma_options{ 0, 1 } );
+			cma.add_stop_condition( std::make_unique< max_steps_condition >( 20 ) );
+			auto& fr = static_cast< file_reporter& >( cma.add_reporter( std::make_unique< file_reporter >( path( folder.string() ) ) ) );
+			fr.binary_history_ = true;
+			fr.output_par_history_ = true;
+			cma.run();
+		}
+		binary_history_reader h( path( ( folder / "history.bin" ).string() ) );
+		XO_CHECK( h.rows() == 20 );
+		XO_CHECK( h.columns() == 3 + obj.dim() );
+		XO_CHECK( h.column( "generation" ).back() == 19.0 );
+
+		std::filesystem::remove_all( folder );
+	}
+}
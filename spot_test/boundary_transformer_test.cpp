@@ -0,0 +1,109 @@
+#include "xo/system/test_case.h"
+
+#include "spot/boundary_transformer.h"
+#include "spot/cma_kernels.h"
+#include "spot/cma_optimizer.h"
+#include "spot/evaluator.h"
+#include "spot/test_objectives.h"
+#include <random>
+
+namespace spot
+{
+	XO_TEST_CASE( boundary_transformer_test )
+	{
+		objective_info info;
+		for ( index_t i = 0; i < 19; ++i )
+			info.add( par_info( "p" + std::to_string( i ), 0, 1, -1 - par_t( i ), 1 + par_t( i ) / 2 ) );
+
+		std::mt19937_64 rng( 123 );
+		std::normal_distribution< par_t > normal( 0, 10 );
+		vector< par_vec > points( 50, par_vec( info.dim() ) );
+		for ( auto& p : points )
+			for ( auto& v : p )
+				v = normal( rng );
+
+		auto check_boundary_transformer = [&]( boundary_transformer& bt ) {
+			const auto n = info.dim();
+			vector< par_t > batch;
+			for ( auto& p : points )
+				batch.insert( batch.end(), p.begin(), p.end() );
+			bt.apply_batch( batch.data(), points.size() );
+
+			for ( index_t k = 0; k < points.size(); ++k )
+			{
+				// batch and single transformations are identical and feasible
+				auto y = points[k];
+				bt.apply( y );
+				XO_CHECK( std::equal( y.begin(), y.end(), batch.begin() + k * n ) );
+				XO_CHECK( info.is_feasible( y ) );
+
+				// inverse maps back to a preimage of y
+				auto x = y;
+				bt.apply_inverse( x );
+				bt.apply( x );
+				for ( index_t i = 0; i < n; ++i )
+					XO_CHECK( std::abs( x[i] - y[i] ) < 1e-4 * ( info[i].max - info[i].min ) );
+			}
+
+			// batch inverse matches single inverse
+			auto inv = batch;
+			bt.apply_inverse_batch( inv.data(), points.size() );
+			for ( index_t k = 0; k < points.size(); ++k )
+			{
+				par_vec y( batch.begin() + k * n, batch.begin() + ( k + 1 ) * n );
+				bt.apply_inverse( y );
+				XO_CHECK( std::equal( y.begin(), y.end(), inv.begin() + k * n ) );
+			}
+		};
+
+		cmaes_boundary_transformer cmaes_bt( info );
+		reflective_boundary_transformer reflective_bt( info );
+		soft_limit_boundary_transformer soft_limit_bt( info );
+		check_boundary_transformer( cmaes_bt );
+		check_boundary_transformer( reflective_bt );
+		check_boundary_transformer( soft_limit_bt );
+
+		// reflection keeps feasible values, also with empty or unbounded ranges
+		const auto inf = std::numeric_limits< par_t >::infinity();
+		XO_CHECK( reflective_boundary_transform< par_t >( 2, 2, 2 ) == 2 );
+		XO_CHECK( reflective_boundary_transform< par_t >( 3, 2, 2 ) == 2 );
+		XO_CHECK( reflective_boundary_transform< par_t >( 0.5, -inf, inf ) == par_t( 0.5 ) );
+		XO_CHECK( reflective_boundary_transform< par_t >( 0.5, 0, inf ) == par_t( 0.5 ) );
+		XO_CHECK( reflective_boundary_transform< par_t >( -1, 0, inf ) == 1 );
+		XO_CHECK( reflective_boundary_transform< par_t >( 3, -inf, 1 ) == -1 );
+		objective_info unbounded_info;
+		unbounded_info.add( par_info( "fixed", 2, 0.1, 2, 2 ) );
+		unbounded_info.add( par_info( "free", 0.5, 0.1, -inf, inf ) );
+		unbounded_info.add( par_info( "positive", 0.5, 0.1, 0, inf ) );
+		par_vec feasible{ 2, 0.5, 0.5 };
+		reflective_boundary_transformer unbounded_bt( unbounded_info );
+		unbounded_bt.apply_batch( feasible.data(), 1 );
+		XO_CHECK( feasible == par_vec( { 2, 0.5, 0.5 } ) );
+
+		// cmaes transformation with infinite bounds is only quadratic and mirrored at finite bounds
+		objective_info half_info;
+		half_info.add( par_info( "positive", 0.5, 0.1, 0, inf ) );
+		half_info.add( par_info( "free", 0.5, 0.1, -inf, inf ) );
+		half_info.add( par_info( "negative", 0.5, 0.1, -inf, 1 ) );
+		cmaes_boundary_transformer half_bt( half_info );
+		for ( auto [x, y] : { pair< par_vec, par_vec >{ { 0.5, 0.5, 0.5 }, { 0.5, 0.5, 0.5 } }, { { -0.3, -1e6, 1.3 }, { 0.2, -1e6, 0.9 } } } )
+		{
+			auto batch = x;
+			half_bt.apply( x );
+			half_bt.apply_batch( batch.data(), 1 );
+			for ( index_t i = 0; i < x.size(); ++i )
+				XO_CHECK( std::abs( x[i] - y[i] ) < 1e-6 && batch[i] == x[i] );
+		}
+		par_vec quadratic{ 0.01, 0, 0 };
+		half_bt.apply( quadratic );
+		XO_CHECK( std::abs( quadratic[0] - par_t( 0.018 ) ) < 1e-6 );
+
+		// warm starts are injected through the inverse transform
+		auto obj = make_sphere_objective( 5, 0.5, 0.1 );
+		sequential_evaluator eval;
+		cma_optimizer cma( obj, eval );
+		cma.set_boundary_transformer( std::make_unique< cmaes_boundary_transformer >( obj.info() ) );
+		XO_CHECK( cma.inject_candidate( par_vec( 5, 0.0 ) ) );
+		XO_CHECK( cma.sample_population()[0].values() == par_vec( 5, 0.0 ) );
+	}
+}
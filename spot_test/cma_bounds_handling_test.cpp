@@ -0,0 +1,48 @@
+#include "xo/system/test_case.h"
+
+#include "spot/cma_optimizer.h"
+#include "spot/evaluator.h"
+#include "spot/function_objective.h"
+#include "spot/test_objectives.h"
+
+namespace spot
+{
+	XO_TEST_CASE( cma_bounds_handling_test )
+	{
+		// the optimum of the sphere is outside the bounds, at the lower bound of each parameter
+		const size_t d = 10;
+		function_objective obj( sphere, d, 0.5, 0.3, 0.1, 1.0, "bounded_sphere" );
+		sequential_evaluator eval;
+
+		auto run = [&]( cma_bounds_handling bh, double diagonal_covariance ) {
+			cma_options options;
+			options.bounds_handling = bh;
+			options.diagonal_covariance = diagonal_covariance;
+			cma_optimizer cma( obj, eval, options );
+			cma_sampling_stats total;
+			for ( int i = 0; i < 200 && !cma.step(); ++i )
+			{
+				auto& s = cma.sampling_stats();
+				total.infeasible += s.infeasible;
+				total.resamples += s.resamples;
+				total.coordinate_resamples += s.coordinate_resamples;
+				total.repaired += s.repaired;
+			}
+			XO_CHECK( obj.info().is_feasible( cma.best_point().values() ) );
+			XO_CHECK( cma.best_fitness() < d * 0.01 * 1.01 );
+			return total;
+		};
+
+		auto resample = run( cma_bounds_handling::resample, 0 );
+		XO_CHECK( resample.infeasible > 0 && resample.resamples > 0 );
+
+		auto coordinate = run( cma_bounds_handling::resample, 1 );
+		XO_CHECK( coordinate.infeasible > 0 && coordinate.resamples == 0 && coordinate.coordinate_resamples > 0 );
+
+		auto repair = run( cma_bounds_handling::repair, 0 );
+		XO_CHECK( repair.infeasible > 0 && repair.resamples == 0 && repair.repaired == repair.infeasible );
+
+		auto transform = run( cma_bounds_handling::transform, 0 );
+		XO_CHECK( transform.infeasible == 0 && transform.resamples == 0 && transform.repaired == 0 );
+	}
+}
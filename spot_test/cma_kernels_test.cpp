@@ -0,0 +1,105 @@
+#include "xo/system/test_case.h"
+
+#include "spot/cma_kernels.h"
+#include "spot/cma_optimizer.h"
+#include "spot/test_objectives.h"
+#include <random>
+
+namespace spot
+{
+	template< typename T > using matrix = vector< vector< T > >;
+
+	template< typename T, typename U > matrix< T > convert( const matrix< U >& m ) {
+		matrix< T > r;
+		for ( auto& row : m )
+			r.emplace_back( row.begin(), row.end() );
+		return r;
+	}
+
+	XO_TEST_CASE( cma_kernels_test )
+	{
+		const size_t n = 200, mu = 10;
+		std::mt19937_64 rng( 123 );
+		std::normal_distribution< double > normal;
+
+		// random orthonormal basis through Gram-Schmidt
+		matrix< double > B( n, vector< double >( n ) );
+		for ( size_t i = 0; i < n; ++i )
+		{
+			for ( auto& v : B[i] )
+				v = normal( rng );
+			for ( size_t k = 0; k < i; ++k )
+			{
+				double dot = 0;
+				for ( size_t j = 0; j < n; ++j ) dot += B[i][j] * B[k][j];
+				for ( size_t j = 0; j < n; ++j ) B[i][j] -= dot * B[k][j];
+			}
+			double norm = 0;
+			for ( auto v : B[i] ) norm += v * v;
+			for ( auto& v : B[i] ) v /= std::sqrt( norm );
+		}
+		vector< double > d( n ), z( n ), pc( n ), weights( mu, 1.0 / mu );
+		for ( size_t i = 0; i < n; ++i )
+		{
+			d[i] = std::exp( normal( rng ) );
+			z[i] = normal( rng );
+			pc[i] = normal( rng );
+		}
+		matrix< double > steps( mu, vector< double >( n ) );
+		for ( auto& s : steps )
+			for ( auto& v : s )
+				v = normal( rng );
+
+		// sampling
+		vector< double > dz( n ), y( n );
+		vector< float > df( d.begin(), d.end() ), zf( z.begin(), z.end() ), dzf( n ), yf( n );
+		auto Bf = convert< float >( B );
+		cma_transform_sample( n, B, d.data(), z.data(), dz.data(), y.data() );
+		cma_transform_sample( n, Bf, df.data(), zf.data(), dzf.data(), yf.data() );
+		double max_y = 0, max_y_error = 0;
+		for ( size_t i = 0; i < n; ++i )
+		{
+			max_y = std::max( max_y, std::abs( y[i] ) );
+			max_y_error = std::max( max_y_error, std::abs( y[i] - yf[i] ) );
+		}
+		XO_CHECK( max_y_error < 1e-5 * max_y );
+
+		// covariance update
+		matrix< double > C( n );
+		for ( size_t i = 0; i < n; ++i )
+			C[i].assign( i + 1, 0.0 ), C[i][i] = d[i] * d[i];
+		auto Cf = convert< float >( C );
+		auto stepsf = convert< float >( steps );
+		vector< float > pcf( pc.begin(), pc.end() ), weightsf( weights.begin(), weights.end() );
+		cma_update_covariance( n, C, 0.9, 0.02, 0.08, pc.data(), mu, weights.data(), steps, false );
+		cma_update_covariance( n, Cf, 0.9f, 0.02f, 0.08f, pcf.data(), mu, weightsf.data(), stepsf, false );
+		double max_c_error = 0;
+		for ( size_t i = 0; i < n; ++i )
+			for ( size_t j = 0; j <= i; ++j )
+				max_c_error = std::max( max_c_error, std::abs( C[i][j] - Cf[i][j] ) / std::sqrt( C[i][i] * C[j][j] ) );
+		XO_CHECK( max_c_error < 1e-5 );
+
+		// boundary transformation
+		const double lb = -2.0, ub = 3.0;
+		const auto al = cmaes_boundary_margin( lb, ub, lb ), au = cmaes_boundary_margin( lb, ub, ub );
+		for ( double x = -20; x <= 20; x += 0.01 )
+		{
+			auto xd = cmaes_boundary_transform( x, lb, ub, al, au );
+			auto xf = cmaes_boundary_transform( float( x ), float( lb ), float( ub ), float( al ), float( au ) );
+			XO_CHECK( xd >= lb && xd <= ub );
+			XO_CHECK( std::abs( xd - xf ) < 1e-5 * ( ub - lb ) );
+			if ( x > lb + al && x < ub - au )
+				XO_CHECK( xd == x );
+		}
+
+		// optimization results with single precision sampling are similar to double
+		auto obj = make_ellipsoid_objective( 40, 1.0, 0.5 );
+		sequential_evaluator eval;
+		cma_optimizer cma_double( obj, eval, cma_options{ 0, 1 } );
+		cma_optimizer cma_single( obj, eval, cma_options{ 0, 1, cma_weights::log, -1, true } );
+		cma_double.run( 1000 );
+		cma_single.run( 1000 );
+		XO_CHECK( cma_double.best_fitness() < 1e-6 );
+		XO_CHECK( cma_single.best_fitness() < 1e-6 );
+	}
+}
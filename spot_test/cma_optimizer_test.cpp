@@ -16,15 +16,15 @@ namespace spot
 		int lambda = 0;
 		std::vector< double > init_mean( dim, 0.0 );
 		std::vector< double > init_std( dim, 0.3 );
-		std::vector< double > lower( dim, -1e12 );
-		std::vector< double > upper( dim, -1e12 );
+		par_vec lower( dim, -1e12 );
+		par_vec upper( dim, -1e12 );
 
 		// init c-cmaes
 		cmaes_t evo;
 		double* arFunvals = cmaes_init( &evo, dim, &init_mean[0], &init_std[0], seed, lambda, "no" );
 
 		// init cma_optimizer
-		function_objective obj( cigtab, init_mean, init_std, lower, upper );
+		function_objective obj( cigtab, par_vec( init_mean.begin(), init_mean.end() ), par_vec( init_std.begin(), init_std.end() ), lower, upper );
 		async_evaluator eval( 32 );
 		cma_optimizer cma( obj, eval, cma_options{ lambda, seed } );
 
@@ -7,7 +7,10 @@
 #include "xo/system/log.h"
 #include "spot/mes_optimizer.h"
 #include "spot/test_objectives.h"
+#include "spot/optimizer_pool.h"
 #include "xo/time/stopwatch.h"
+#include <algorithm>
+#include <numeric>
 
 namespace spot
 {
@@ -73,4 +76,46 @@ namespace spot
 		sw.split( "mes" );
 		xo::log::info( "Benchmark results:\n", sw.get_report() );
 	}
+
+	size_t test_pool_evaluations_to_target( const objective& obj, fitness_t target, const prop_node& pn, int seed_offset )
+	{
+		sequential_evaluator eval;
+		optimizer_pool pool( obj, eval, pn );
+		pool.add_stop_condition( std::make_unique<spot::target_fitness_condition>( target ) );
+		for ( int i = 0; i < 6; ++i )
+		{
+			auto cma = std::make_unique<cma_optimizer>( obj, eval, cma_options{ 0, seed_offset + i + 1 } );
+			cma->add_stop_condition( std::make_unique<spot::min_progress_condition>( min_progress ) );
+			cma->add_stop_condition( std::make_unique<spot::max_steps_condition>( 2000 ) );
+			pool.push_back( std::move( cma ) );
+		}
+		pool.run();
+		return pool.best_fitness() <= target ? pool.evaluation_count() : 0;
+	}
+
+	void benchmark_migration() {
+		std::vector< std::pair< function_objective, fitness_t > > objs = {
+			{ make_rastrigin_objective( 10 ), 5.0 }, { make_schwefel_objective( 10 ), 1000.0 } };
+		for ( auto& [obj, target] : objs )
+		{
+			for ( string topology : { "none", "ring", "best" } )
+			{
+				prop_node pn;
+				pn.set( "active_optimizations", 6 );
+				if ( topology != "none" ) {
+					pn.set( "migration_interval", 10 );
+					pn.set( "migration_topology", topology );
+				}
+
+				// evaluations to target, zero if the target was not reached
+				std::vector< size_t > evals;
+				for ( int seed = 0; seed < 60; seed += 6 )
+					evals.emplace_back( test_pool_evaluations_to_target( obj, target, pn, seed ) );
+				auto successes = std::count_if( evals.begin(), evals.end(), []( size_t e ) { return e > 0; } );
+				auto total = std::accumulate( evals.begin(), evals.end(), size_t( 0 ) );
+				xo::log::info( xo::stringf( "%-20s\t%-6s\tsuccess=%d/%d\tevaluations=%g", obj.name().c_str(), topology.c_str(),
+					int( successes ), int( evals.size() ), successes > 0 ? double( total ) / successes : 0.0 ) );
+			}
+		}
+	}
 }
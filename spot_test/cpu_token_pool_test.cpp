@@ -0,0 +1,49 @@
+#include "xo/system/test_case.h"
+
+#include "spot/cpu_token_pool.h"
+#include "spot/pooled_evaluator.h"
+#include "spot/function_objective.h"
+#include "spot/test_objectives.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace spot
+{
+	XO_TEST_CASE( cpu_token_pool_test )
+	{
+		string name = "spot_cpu_token_pool_test";
+		cpu_token_pool::remove( name );
+
+		// a second handle to the same pool behaves like another process
+		{
+			cpu_token_pool a( name, 2 );
+			cpu_token_pool b( name, 8 ); // token count is set by the creator
+			XO_CHECK( a.try_acquire() && b.try_acquire() );
+			XO_CHECK( !a.try_acquire() && !b.try_acquire() );
+			a.release();
+			XO_CHECK( b.try_acquire() );
+			b.release();
+			b.release();
+		}
+		cpu_token_pool::remove( name );
+
+		// pooled_evaluator workers share tokens
+		cpu_token_pool pool( name, 2 );
+		std::atomic_int active = 0, max_active = 0;
+		function_objective obj( [&]( const par_vec& v ) {
+			auto n = ++active;
+			for ( int m = max_active; n > m && !max_active.compare_exchange_weak( m, n ); );
+			std::this_thread::sleep_for( std::chrono::milliseconds( 2 ) );
+			--active;
+			return sphere( v );
+			}, 2, 0.0, 1.0, -10.0, 10.0 );
+		pooled_evaluator eval( 8 );
+		eval.set_cpu_token_pool( &pool );
+		search_point_vec points( 32, search_point( obj.info() ) );
+		auto results = eval.evaluate( obj, points, xo::stop_token() );
+		XO_CHECK( results.size() == 32 && results.back() );
+		XO_CHECK( max_active == 2 );
+		cpu_token_pool::remove( name );
+	}
+}
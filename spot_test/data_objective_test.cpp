@@ -0,0 +1,147 @@
+#include "xo/system/test_case.h"
+
+#include "spot/data_objective.h"
+#include "spot/pooled_evaluator.h"
+#include "spot/cma_optimizer.h"
+#include "spot/minibatch_reporter.h"
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+namespace spot
+{
+	struct quadratic_model : public data_model< 3 >
+	{
+		using data_model::data_model;
+		double operator()( double x ) const { return ( p[0] * x + p[1] ) * x + p[2]; }
+	};
+
+	struct batch_quadratic_model : public quadratic_model
+	{
+		using quadratic_model::quadratic_model;
+		void evaluate( const double* x, double* y, size_t n ) const {
+			const double a = p[0], b = p[1], c = p[2];
+			for ( size_t i = 0; i < n; ++i )
+				y[i] = ( a * x[i] + b ) * x[i] + c;
+		}
+	};
+
+	XO_TEST_CASE( data_objective_test )
+	{
+		static_assert( !has_batch_evaluate< quadratic_model >::value );
+		static_assert( has_batch_evaluate< batch_quadratic_model >::value );
+
+		vector< double > inputs, outputs;
+		for ( int i = 0; i < 100003; ++i )
+		{
+			inputs.push_back( 1e-4 * i );
+			outputs.push_back( 0.5 * inputs.back() * inputs.back() - 1.0 + 0.01 * std::sin( i ) );
+		}
+		data_objective< quadratic_model > scalar_obj( inputs, outputs );
+		data_objective< batch_quadratic_model > batch_obj( inputs, outputs );
+		search_point sp( scalar_obj.info(), par_vec{ 0.4, 0.1, -0.9 } );
+
+		double expected = 0;
+		for ( index_t i = 0; i < inputs.size(); ++i )
+			expected += xo::squared( ( 0.4 * inputs[i] + 0.1 ) * inputs[i] - 0.9 - outputs[i] );
+		expected /= inputs.size();
+
+		auto seq = sequential_evaluator();
+		auto pooled = pooled_evaluator( 4 );
+		auto scalar_result = seq.evaluate( scalar_obj, { sp }, xo::stop_token() ).front().value();
+		auto batch_result = seq.evaluate( batch_obj, { sp }, xo::stop_token() ).front().value();
+		auto pooled_result = pooled.evaluate( batch_obj, { sp }, xo::stop_token() ).front().value();
+		const auto tolerance = 1e4 * std::numeric_limits< fitness_t >::epsilon() * expected;
+		XO_CHECK( std::abs( scalar_result - expected ) < tolerance );
+		XO_CHECK( std::abs( batch_result - scalar_result ) < tolerance );
+		XO_CHECK( pooled_result == batch_result ); // summation order does not depend on threads
+	}
+}
+
+namespace spot
+{
+	XO_TEST_CASE( data_objective_mapped_test )
+	{
+		vector< double > inputs, outputs;
+		for ( int i = 0; i < 20001; ++i )
+		{
+			inputs.push_back( 1e-3 * i );
+			outputs.push_back( 2.0 * inputs.back() - 0.5 );
+		}
+		auto filename = path( "data_objective_mapped_test.bin" );
+		write_data_file( filename, inputs, outputs );
+
+		{
+			auto source = std::make_shared< mapped_data_source< double, double > >( filename, true );
+			XO_CHECK( source->size() == inputs.size() );
+			data_objective< quadratic_model > mapped_obj( source );
+			data_objective< quadratic_model > memory_obj( inputs, outputs );
+			search_point sp( mapped_obj.info(), par_vec{ 0.1, 1.9, -0.4 } );
+
+			auto pooled = pooled_evaluator( 4 );
+			auto mapped_result = pooled.evaluate( mapped_obj, { sp }, xo::stop_token() ).front().value();
+			auto memory_result = pooled.evaluate( memory_obj, { sp }, xo::stop_token() ).front().value();
+			XO_CHECK( mapped_result == memory_result );
+
+			// sample types must match the file
+			bool type_mismatch = false;
+			try { mapped_data_source< float, double > m( filename ); }
+			catch ( std::exception& ) { type_mismatch = true; }
+			XO_CHECK( type_mismatch );
+		}
+		std::remove( filename.c_str() );
+	}
+}
+
+namespace spot
+{
+	XO_TEST_CASE( data_objective_minibatch_test )
+	{
+		vector< double > inputs, outputs;
+		for ( int i = 0; i < 200000; ++i )
+		{
+			inputs.push_back( std::fmod( 0.618034 * i, 2.0 ) - 1.0 );
+			outputs.push_back( ( 0.4 * inputs.back() + 0.1 ) * inputs.back() - 0.9 + 0.1 * std::sin( 7.0 * i ) );
+		}
+
+		// all points of a generation use the same subset
+		data_objective< quadratic_model > obj( inputs, outputs );
+		search_point sp( obj.info(), par_vec{ 0.4, 0.1, -0.9 } );
+		obj.set_minibatch( 1000, 1 );
+		XO_CHECK( obj.minibatch_size() >= 1000 && obj.minibatch_size() < 1100 );
+		auto fitness1 = obj.evaluate( sp, xo::stop_token() ).value();
+		XO_CHECK( obj.evaluate( sp, xo::stop_token() ).value() == fitness1 );
+		obj.set_minibatch( 1000, 2 );
+		XO_CHECK( obj.evaluate( sp, xo::stop_token() ).value() != fitness1 );
+
+		// the subset cannot be selected by multiple optimizers
+		{
+			sequential_evaluator eval;
+			cma_optimizer cma1( obj, eval ), cma2( obj, eval );
+			cma1.add_reporter( std::make_unique< minibatch_reporter >( obj ) );
+			cma2.add_reporter( std::make_unique< minibatch_reporter >( obj ) );
+			cma1.step();
+			cma2.step();
+			XO_CHECK( obj.bound_optimizer() == &cma1 );
+		}
+		XO_CHECK( obj.bound_optimizer() == nullptr );
+
+		auto optimize = [&]( bool minibatch ) {
+			data_objective< quadratic_model > o( inputs, outputs );
+			sequential_evaluator eval;
+			cma_optimizer cma( o, eval, cma_options{ 0, 1 } );
+			cma.add_stop_condition( std::make_unique< min_progress_condition >( 1e-5, 100 ) );
+			cma.add_stop_condition( std::make_unique< max_steps_condition >( 2000 ) );
+			minibatch_reporter* mbr = nullptr;
+			if ( minibatch )
+				mbr = &static_cast<minibatch_reporter&>( cma.add_reporter( std::make_unique< minibatch_reporter >( o ) ) );
+			cma.run();
+			auto fitness = mbr ? mbr->confirmed_fitness() : cma.best_fitness();
+			return std::make_pair( fitness, o.sample_evaluations() );
+		};
+		auto full = optimize( false );
+		auto mini = optimize( true );
+		XO_CHECK( mini.first < full.first * 1.01 );
+		XO_CHECK( mini.second < full.second / 2 );
+	}
+}
@@ -7,8 +7,10 @@
 #include "spot/batch_evaluator.h"
 #include "spot/test_objectives.h"
 #include "spot/pooled_evaluator.h"
+#include "spot/function_objective.h"
 #include <chrono>
 #include <thread>
+#include <atomic>
 
 using namespace std::chrono_literals;
 
@@ -74,4 +76,175 @@ namespace spot
 
 		xo::log::info( "results:\n", sw.get_report() );
 	}
+
+	struct counting_context : public objective_context
+	{
+		int evaluations = 0;
+	};
+
+	struct context_objective : public objective
+	{
+		context_objective() : objective( make_objective_info( g_dim, 0.0, 1.0, -10.0, 10.0 ) ) {}
+		virtual u_ptr<objective_context> create_context() const override {
+			++contexts_created_;
+			return std::make_unique<counting_context>();
+		}
+		virtual result<fitness_t> evaluate( const search_point& point, const xo::stop_token& st, objective_context* context ) const override {
+			xo_error_if( !context, "Missing objective context" );
+			++static_cast<counting_context*>( context )->evaluations;
+			return sphere( point.values() );
+		}
+		mutable std::atomic_int contexts_created_ = 0;
+	};
+
+	XO_TEST_CASE( objective_context_test )
+	{
+		const int threads = 4;
+		context_objective obj;
+		auto seq_eval = sequential_evaluator();
+		auto pooled_eval = pooled_evaluator( threads, xo::thread_priority::low );
+		search_point_vec points( 64, search_point( obj.info() ) );
+
+		for ( int i = 0; i < 10; ++i ) {
+			auto results = pooled_eval.evaluate( obj, points, xo::stop_token() );
+			XO_CHECK( xo::count_if( results, []( const auto& r ) { return !r; } ) == 0 );
+		}
+		XO_CHECK( obj.contexts_created_ <= threads );
+
+		for ( int i = 0; i < 10; ++i )
+			seq_eval.evaluate( obj, points, xo::stop_token() );
+		XO_CHECK( obj.contexts_created_ <= threads + 1 );
+	}
+
+	XO_TEST_CASE( evaluator_metrics_test )
+	{
+		const int threads = 4;
+		function_objective obj( []( const par_vec& v ) {
+			std::this_thread::sleep_for( 2ms );
+			xo_error_if( v[0] < 0, "Negative value" );
+			return sphere( v );
+			}, 2, 0.0, 1.0, -10.0, 10.0 );
+		auto pooled_eval = pooled_evaluator( threads, xo::thread_priority::low );
+		search_point_vec points( 32, search_point( obj.info(), par_vec{ 1.0, 1.0 } ) );
+		points[0].set_values( par_vec{ -1.0, 1.0 } );
+		pooled_eval.metrics().reset();
+		pooled_eval.evaluate( obj, points, xo::stop_token() );
+
+		auto m = pooled_eval.metrics().snapshot();
+		XO_CHECK( m.evaluations == 32 );
+		XO_CHECK( m.errors == 1 );
+		XO_CHECK( m.in_flight == 0 );
+		XO_CHECK( m.workers == threads );
+		XO_CHECK( m.execution.total == 32 && m.queue_wait.total == 32 );
+		XO_CHECK( m.execution.percentile( 0.5 ) >= 0.002 );
+		XO_CHECK( m.queue_wait.percentile( 1.0 ) >= 0.002 ); // tasks wait for the first batch
+		XO_CHECK( m.utilization() > 0 && m.utilization() <= 1.0 );
+		XO_CHECK( m.cpu_ratio() < 0.5 ); // sleeping does not use cpu time
+	}
+
+	XO_TEST_CASE( pooled_evaluator_resize_test )
+	{
+		std::atomic_int active = 0, max_active = 0;
+		function_objective obj( [&]( const par_vec& v ) {
+			auto n = ++active;
+			for ( int m = max_active; n > m && !max_active.compare_exchange_weak( m, n ); );
+			std::this_thread::sleep_for( 20ms );
+			--active;
+			return sphere( v );
+			}, 2, 0.0, 1.0, -10.0, 10.0 );
+		search_point_vec points( 48, search_point( obj.info() ) );
+		auto eval = pooled_evaluator( 2, xo::thread_priority::low );
+
+		// grow while evaluating, without waiting for running evaluations
+		auto f = std::async( std::launch::async, [&]() { return eval.evaluate( obj, points, xo::stop_token() ); } );
+		std::this_thread::sleep_for( 30ms );
+		eval.set_max_threads( 6, xo::thread_priority::low );
+		XO_CHECK( f.get().size() == points.size() );
+		XO_CHECK( max_active > 2 && max_active <= 6 ); // new threads take queued work from the running call
+		XO_CHECK( eval.thread_count() == 6 );
+
+		// shrink while evaluating
+		f = std::async( std::launch::async, [&]() { return eval.evaluate( obj, points, xo::stop_token() ); } );
+		std::this_thread::sleep_for( 30ms );
+		eval.set_max_threads( 1, xo::thread_priority::low );
+		std::this_thread::sleep_for( 30ms );
+		max_active = 0;
+		XO_CHECK( f.get().size() == points.size() );
+		XO_CHECK( max_active <= 1 );
+
+		// autoscale to queue depth and load
+		size_t hardware_threads = std::thread::hardware_concurrency();
+		double load = 1000;
+		eval.set_autoscale( autoscale_options{ 1, 0, 0.0, [&]() { return load; } } );
+		eval.evaluate( obj, search_point_vec( 8, search_point( obj.info() ) ), xo::stop_token() );
+		XO_CHECK( eval.thread_count() == 1 );
+		load = 0;
+		eval.evaluate( obj, search_point_vec( 8, search_point( obj.info() ) ), xo::stop_token() );
+		XO_CHECK( eval.thread_count() == std::min< size_t >( hardware_threads, 8 ) );
+		eval.evaluate( obj, search_point_vec( 2, search_point( obj.info() ) ), xo::stop_token() );
+		XO_CHECK( eval.thread_count() == std::min< size_t >( hardware_threads, 2 ) );
+	}
+
+	XO_TEST_CASE( evaluator_cancellation_test )
+	{
+		// objective does not check the stop token
+		std::atomic_int started = 0;
+		function_objective obj( [&]( const par_vec& v ) { ++started; std::this_thread::sleep_for( 50ms ); return sphere( v ); }, 2, 0.0, 1.0, -10.0, 10.0 );
+		search_point_vec points( 64, search_point( obj.info() ) );
+		auto seq_eval = sequential_evaluator();
+		auto async_eval = async_evaluator( 4, xo::thread_priority::low );
+		auto batch_eval = batch_evaluator( xo::thread_priority::low );
+		auto pooled_eval = pooled_evaluator( 4, xo::thread_priority::low );
+
+		for ( evaluator* e : std::initializer_list< evaluator* >{ &seq_eval, &async_eval, &batch_eval, &pooled_eval } )
+		{
+			xo::stop_source ss;
+			started = 0;
+			auto f = std::async( std::launch::async, [&]() { return e->evaluate( obj, points, ss.get_token() ); } );
+			std::this_thread::sleep_for( 75ms );
+			auto stop_time = std::chrono::steady_clock::now();
+			ss.request_stop();
+			auto results = f.get();
+
+			// only running evaluations are completed after the stop request, which takes up to 50ms
+			std::chrono::duration< double > latency = std::chrono::steady_clock::now() - stop_time;
+			xo::log::info( "cancellation latency: ", latency.count() );
+
+			// running evaluations are completed, all evaluations that were not started are cancelled
+			XO_CHECK( results.size() == points.size() );
+			auto cancelled = xo::count_if( results, []( const auto& r ) { return !r && r.error().message() == evaluation_cancelled_message; } );
+			auto completed = xo::count_if( results, []( const auto& r ) { return bool( r ); } );
+			XO_CHECK( completed == size_t( started ) );
+			XO_CHECK( size_t( cancelled + completed ) == points.size() );
+			XO_CHECK( cancelled == e->metrics().snapshot().cancelled );
+			if ( e != &batch_eval )
+				XO_CHECK( cancelled > 0 && results.front() );
+		}
+	}
+
+	XO_TEST_CASE( pooled_evaluator_chunk_test )
+	{
+		auto obj = make_sphere_objective( 4 );
+		auto eval = pooled_evaluator( 4, xo::thread_priority::low );
+		search_point_vec points;
+		for ( int i = 0; i < 1000; ++i )
+			points.emplace_back( obj.info(), par_vec{ par_t( 0.001 * i ), 1.0, 2.0, 3.0 } );
+
+		// grouping is disabled by default
+		eval.evaluate( obj, points, xo::stop_token() );
+		XO_CHECK( eval.chunk_size( obj, points.size() ) == 1 );
+
+		// cheap evaluations are grouped after the cost is measured
+		eval.set_min_task_duration( 1e-4 );
+		XO_CHECK( eval.chunk_size( obj, points.size() ) > 1 );
+		auto results = eval.evaluate( obj, points, xo::stop_token() );
+		for ( index_t i = 0; i < points.size(); ++i )
+			XO_CHECK( results[i] && results[i].value() == sphere( points[i].values() ) );
+
+		// slow evaluations use one task per point, the cost is estimated per objective
+		function_objective slow_obj( []( const par_vec& v ) { std::this_thread::sleep_for( 1ms ); return sphere( v ); }, 2, 0.0, 1.0, -10.0, 10.0 );
+		eval.evaluate( slow_obj, search_point_vec( 8, search_point( slow_obj.info() ) ), xo::stop_token() );
+		XO_CHECK( eval.chunk_size( slow_obj, 1000 ) == 1 );
+		XO_CHECK( eval.chunk_size( obj, points.size() ) > 1 );
+	}
 }
@@ -0,0 +1,72 @@
+#include "xo/system/test_case.h"
+
+#include "spot/journal_evaluator.h"
+#include "spot/cma_optimizer.h"
+#include "spot/mes_optimizer.h"
+#include "spot/function_objective.h"
+#include "spot/test_objectives.h"
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+
+namespace spot
+{
+	template< typename O, typename Options >
+	fitness_t run_journal( const objective& obj, evaluator& eval, const Options& options, size_t steps )
+	{
+		O opt( obj, eval, options );
+		opt.add_stop_condition( std::make_unique< max_steps_condition >( steps ) );
+		opt.run();
+		return opt.best_fitness();
+	}
+
+	XO_TEST_CASE( journal_evaluator_test )
+	{
+		auto folder = std::filesystem::temp_directory_path() / "spot_journal_evaluator_test";
+		std::filesystem::create_directories( folder );
+		auto filename = path( ( folder / "journal.bin" ).string() );
+		std::filesystem::remove( filename.str() );
+
+		std::atomic< size_t > count = 0;
+		function_objective obj( [&]( const par_vec& v ) { ++count; return rosenbrock( v ); }, 4, 0.0, 1.0, -10.0, 10.0 );
+		sequential_evaluator eval;
+		cma_options options{ 8, 1 }; // fixed seed
+
+		auto reference = run_journal< cma_optimizer >( obj, eval, options, 50 );
+
+		// interrupted run
+		{
+			journal_evaluator journal( eval, filename );
+			run_journal< cma_optimizer >( obj, journal, options, 30 );
+			XO_CHECK( journal.journal_evaluations() == 30 * 8 );
+		}
+		std::ofstream( filename.str(), std::ios::app | std::ios::binary ) << "partial entry";
+
+		// resumed run only evaluates the remaining steps
+		{
+			count = 0;
+			journal_evaluator journal( eval, filename );
+			auto resumed = run_journal< cma_optimizer >( obj, journal, options, 50 );
+			XO_CHECK( journal.replayed_evaluations() == 30 * 8 );
+			XO_CHECK( count == 20 * 8 );
+			XO_CHECK( resumed == reference );
+		}
+
+		// a different optimizer does not match the journal, entries are discarded
+		{
+			journal_evaluator journal( eval, filename );
+			run_journal< mes_optimizer >( obj, journal, mes_options{ 8, 1 }, 10 );
+			XO_CHECK( journal.replayed_evaluations() == 0 );
+			XO_CHECK( journal.journal_evaluations() == 10 * 8 );
+		}
+		{
+			count = 0;
+			journal_evaluator journal( eval, filename );
+			run_journal< mes_optimizer >( obj, journal, mes_options{ 8, 1 }, 10 );
+			XO_CHECK( journal.replayed_evaluations() == 10 * 8 );
+			XO_CHECK( count == 0 );
+		}
+
+		std::filesystem::remove_all( folder );
+	}
+}
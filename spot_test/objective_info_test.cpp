@@ -0,0 +1,47 @@
+#include "xo/system/test_case.h"
+
+#include "spot/objective_info.h"
+#include <filesystem>
+#include <fstream>
+
+namespace spot
+{
+	XO_TEST_CASE( objective_info_test )
+	{
+		objective_info info;
+		for ( index_t i = 0; i < 10; ++i )
+			info.add( par_info( "p" + std::to_string( i ), par_t( i ), 1, -par_t( i + 1 ), par_t( i + 1 ) ) );
+
+		auto check_arrays = [&]() {
+			XO_CHECK( info.means().size() == info.dim() && info.stds().size() == info.dim() );
+			XO_CHECK( info.lower_bounds().size() == info.dim() && info.upper_bounds().size() == info.dim() );
+			for ( index_t i = 0; i < info.dim(); ++i )
+			{
+				XO_CHECK( info.means()[i] == info[i].mean && info.stds()[i] == info[i].std );
+				XO_CHECK( info.lower_bounds()[i] == info[i].min && info.upper_bounds()[i] == info[i].max );
+			}
+		};
+		check_arrays();
+
+		// arrays follow changes and locked parameters
+		info.set_std_minimum( 0, 2 );
+		check_arrays();
+		auto filename = std::filesystem::temp_directory_path() / "spot_objective_info_test.par";
+		std::ofstream( filename ) << "p3 0.5 0.5 0\np7 1 1 0\n";
+		XO_CHECK( info.import_locked( path( filename.string() ) ).first == 2 );
+		XO_CHECK( info.dim() == 8 && info.find_index( "p3" ) == no_index );
+		check_arrays();
+
+		// feasibility and clamping of a population
+		const size_t count = 3;
+		par_vec points( count * info.dim(), 0 );
+		points[info.dim() + 2] = 100; // second point is infeasible
+		points[2 * info.dim() + 7] = -100; // third point too
+		bool feasible[count];
+		XO_CHECK( info.is_feasible_batch( points.data(), count, feasible ) == 1 );
+		XO_CHECK( feasible[0] && !feasible[1] && !feasible[2] );
+		XO_CHECK( info.clamp_batch( points.data(), count ) == 2 );
+		XO_CHECK( points[info.dim() + 2] == info.upper_bounds()[2] && points[2 * info.dim() + 7] == info.lower_bounds()[7] );
+		XO_CHECK( info.is_feasible_batch( points.data(), count, feasible ) == count );
+	}
+}
@@ -0,0 +1,115 @@
+#include "xo/system/test_case.h"
+
+#include "spot/optimizer_pool.h"
+#include "spot/cma_optimizer.h"
+#include "spot/pooled_evaluator.h"
+#include "spot/test_objectives.h"
+#include "spot/function_objective.h"
+#include "spot/evaluator.h"
+#include <limits>
+#include "xo/container/prop_node.h"
+
+namespace spot
+{
+	XO_TEST_CASE( optimizer_pool_test )
+	{
+		auto obj = make_rosenbrock_objective( 4 );
+		auto eval = pooled_evaluator( 0, xo::thread_priority::low );
+		prop_node pn;
+		optimizer_pool pool( obj, eval, pn );
+		for ( int i = 0; i < 8; ++i )
+		{
+			auto opt = std::make_unique< cma_optimizer >( obj, eval, cma_options{ 0, i + 1 } );
+			opt->add_stop_condition( std::make_unique< max_steps_condition >( 200 ) );
+			pool.push_back( std::move( opt ) );
+		}
+
+		auto* sc = pool.run();
+		XO_CHECK( sc != nullptr && !sc->error() );
+		XO_CHECK( pool.all_optimizers_stopped() );
+		for ( auto& o : pool.optimizers() )
+			XO_CHECK( pool.best_fitness() <= o->best_fitness() );
+		XO_CHECK( pool.best_fitness() < 1e-3 );
+	}
+
+	XO_TEST_CASE( optimizer_pool_successive_halving_test )
+	{
+		auto obj = make_rosenbrock_objective( 4 );
+		auto eval = pooled_evaluator( 0, xo::thread_priority::low );
+		prop_node pn;
+		pn.set( "successive_halving", true );
+		pn.set( "halving_min_steps", 10 );
+		pn.set( "halving_reduction_factor", 3 );
+		pn.set( "max_evaluations", 2000 );
+		optimizer_pool pool( obj, eval, pn );
+		for ( int i = 0; i < 9; ++i )
+			pool.push_back( std::make_unique< cma_optimizer >( obj, eval, cma_options{ 0, i + 1 } ) );
+
+		auto* sc = pool.run();
+		XO_CHECK( dynamic_cast< const max_evaluations_condition* >( sc ) != nullptr );
+		XO_CHECK( pool.evaluation_count() >= 2000 );
+
+		// 9 members run 10 steps, 3 of those run 30 steps, 1 continues
+		size_t over_first = 0, over_second = 0;
+		for ( auto& o : pool.optimizers() )
+		{
+			over_first += o->current_step() > 10;
+			over_second += o->current_step() > 30;
+		}
+		XO_CHECK( over_first <= 3 );
+		XO_CHECK( over_second <= 1 );
+	}
+
+	XO_TEST_CASE( optimizer_pool_migration_test )
+	{
+		// injected candidates are evaluated as-is
+		auto sphere = make_sphere_objective( 5, 3.0, 1.0 );
+		sequential_evaluator seq_eval;
+		cma_optimizer cma( sphere, seq_eval, cma_options{ 0, 1 } );
+		XO_CHECK( cma.inject_candidate( par_vec( 5, 0.0 ) ) );
+		cma.step();
+		XO_CHECK( cma.best_fitness() == 0 );
+
+		auto obj = make_rastrigin_objective( 6 );
+		auto eval = pooled_evaluator( 0, xo::thread_priority::low );
+		for ( string topology : { "ring", "best" } )
+		{
+			prop_node pn;
+			pn.set( "migration_interval", 5 );
+			pn.set( "migration_topology", topology );
+			optimizer_pool pool( obj, eval, pn );
+			for ( int i = 0; i < 6; ++i )
+			{
+				auto opt = std::make_unique< cma_optimizer >( obj, eval, cma_options{ 0, i + 1 } );
+				opt->add_stop_condition( std::make_unique< max_steps_condition >( 100 ) );
+				pool.push_back( std::move( opt ) );
+			}
+
+			auto* sc = pool.run();
+			XO_CHECK( sc != nullptr && !sc->error() );
+			for ( auto& o : pool.optimizers() )
+				XO_CHECK( pool.best_fitness() <= o->best_fitness() );
+		}
+	}
+
+	XO_TEST_CASE( optimizer_pool_worst_prediction_test )
+	{
+		// NaN fitness is tracked as the worst fitness, these members are stepped until they stop by themselves
+		function_objective obj( []( const par_vec& v ) { return std::numeric_limits< fitness_t >::quiet_NaN(); }, 3, 0.0, 1.0, -10.0, 10.0 );
+		auto eval = sequential_evaluator();
+		prop_node pn;
+		pn.set( "prediction_window", 5 );
+		optimizer_pool pool( obj, eval, pn );
+		for ( int i = 0; i < 2; ++i )
+		{
+			auto opt = std::make_unique< cma_optimizer >( obj, eval, cma_options{ 0, i + 1 } );
+			opt->add_stop_condition( std::make_unique< max_steps_condition >( 20 ) );
+			pool.push_back( std::move( opt ) );
+		}
+
+		auto* sc = pool.run();
+		XO_CHECK( sc != nullptr && pool.all_optimizers_stopped() );
+		for ( auto& o : pool.optimizers() )
+			XO_CHECK( o->current_step() == 20 );
+	}
+}
@@ -0,0 +1,57 @@
+#include "xo/system/test_case.h"
+
+#include "spot/population_log.h"
+#include "spot/file_reporter.h"
+#include "spot/cma_optimizer.h"
+#include "spot/test_objectives.h"
+#include <filesystem>
+#include <sstream>
+
+namespace spot
+{
+	XO_TEST_CASE( population_log_test )
+	{
+		auto folder = std::filesystem::temp_directory_path() / "spot_population_log_test";
+		std::filesystem::create_directories( folder );
+		auto obj = make_rosenbrock_objective( 3 );
+		sequential_evaluator eval;
+		{
+			cma_optimizer cma( obj, eval, cma_options{ 0, 1 } );
+			cma.add_stop_condition( std::make_unique< max_steps_condition >( 20 ) );
+			auto& fr = static_cast< file_reporter& >( cma.add_reporter( std::make_unique< file_reporter >( path( folder.string() ) ) ) );
+			fr.output_population_log_ = true;
+			fr.output_fitness_history_ = false;
+			cma.run();
+		}
+
+		population_log_reader log( path( ( folder / "population.bin" ).string() ) );
+		XO_CHECK( log.info().dim() == obj.dim() );
+		XO_CHECK( log.info()[1].name == obj.info()[1].name );
+		XO_CHECK( log.size() == 20 );
+		auto idx = log.find_step( 7 );
+		XO_CHECK( idx == 7 );
+		auto rec = log.read( idx );
+		XO_CHECK( rec.step == 7 );
+		XO_CHECK( rec.points.size() == rec.fitnesses.size() && rec.points.size() == rec.durations.size() );
+		XO_CHECK( rec.fitnesses[0] == rosenbrock( rec.points[0] ) );
+		XO_CHECK( rec.durations[0] >= 0.0 );
+		XO_CHECK( log.find_step( 20 ) == no_index );
+
+		// extracted par file matches the search_point output
+		auto par_file = folder / "extracted.par";
+		log.write_par_file( idx, 2, path( par_file.string() ) );
+		std::stringstream expected;
+		expected << search_point( obj.info(), rec.points[2] );
+		std::ifstream str( par_file );
+		std::stringstream extracted;
+		extracted << str.rdbuf();
+		XO_CHECK( extracted.str() == expected.str() );
+
+		// incomplete records at the end of the log are ignored
+		std::ofstream( ( folder / "population.bin" ).string(), std::ios::app | std::ios::binary ) << "partial record";
+		std::ofstream( ( folder / "population.bin.idx" ).string(), std::ios::app | std::ios::binary ).write( "\x14\0\0\0\0\0\0\0\xff\xff\xff\0\0\0\0\0", 16 );
+		XO_CHECK( population_log_reader( path( ( folder / "population.bin" ).string() ) ).size() == 20 );
+
+		std::filesystem::remove_all( folder );
+	}
+}
@@ -0,0 +1,71 @@
+#include "xo/system/test_case.h"
+
+#include "spot/simd_dispatch.h"
+#include "spot/cma_kernels.h"
+#include "spot/math_tools.h"
+#include <random>
+
+namespace spot
+{
+	XO_TEST_CASE( simd_dispatch_test )
+	{
+		// all supported levels should match the scalar kernels exactly
+		const size_t n = 37, mu = 5;
+		std::mt19937_64 rng( 123 );
+		std::normal_distribution< double > normal;
+		auto random_vec = [&]( size_t size ) { vector< double > v( size ); for ( auto& e : v ) e = normal( rng ); return v; };
+		auto random_mat = [&]( size_t rows ) { vector< vector< double > > m( rows ); for ( auto& r : m ) r = random_vec( n ); return m; };
+
+		auto a = random_vec( n ), b = random_vec( n ), pc = random_vec( n ), weights = vector< double >( mu, 1.0 / mu );
+		auto B = random_mat( n ), C0 = random_mat( n ), steps = random_mat( mu );
+		par_vec pa( a.begin(), a.end() ), lb( n, -1 ), ub( n, 1 ), al( n ), au( n );
+		for ( size_t i = 0; i < n; ++i )
+		{
+			al[i] = cmaes_boundary_margin( lb[i], ub[i], lb[i] );
+			au[i] = cmaes_boundary_margin( lb[i], ub[i], ub[i] );
+		}
+
+		const auto& ref = simd_kernels_for( simd_level::scalar );
+		XO_CHECK( simd_supported( simd().level ) );
+		for ( auto l : { simd_level::scalar, simd_level::avx2, simd_level::avx512 } )
+		{
+			if ( !simd_supported( l ) )
+				continue;
+			const auto& k = simd_kernels_for( l );
+			XO_CHECK( k.level == l );
+
+			auto x1 = vec_mul( par_t( 3 ), pa ), x2 = x1, r1 = x1, r2 = x1;
+			k.boundary_transform( n, 1, x1.data(), lb.data(), ub.data(), al.data(), au.data() );
+			ref.boundary_transform( n, 1, x2.data(), lb.data(), ub.data(), al.data(), au.data() );
+			k.reflective_transform( n, 1, r1.data(), lb.data(), ub.data() );
+			ref.reflective_transform( n, 1, r2.data(), lb.data(), ub.data() );
+			for ( size_t i = 0; i < n; ++i )
+			{
+				XO_CHECK( x1[i] == x2[i] && x1[i] >= lb[i] && x1[i] <= ub[i] );
+				XO_CHECK( r1[i] == r2[i] && r1[i] >= lb[i] && r1[i] <= ub[i] );
+			}
+			k.boundary_transform_inverse( n, 1, x1.data(), lb.data(), ub.data(), al.data(), au.data() );
+			ref.boundary_transform_inverse( n, 1, x2.data(), lb.data(), ub.data(), al.data(), au.data() );
+			for ( size_t i = 0; i < n; ++i )
+				XO_CHECK( x1[i] == x2[i] );
+
+			auto c1 = vec_mul( par_t( 3 ), pa ), c2 = c1;
+			XO_CHECK( k.count_out_of_bounds( n, c1.data(), lb.data(), ub.data() ) == ref.count_out_of_bounds( n, c2.data(), lb.data(), ub.data() ) );
+			XO_CHECK( k.clamp( n, 1, c1.data(), lb.data(), ub.data() ) == ref.clamp( n, 1, c2.data(), lb.data(), ub.data() ) );
+			XO_CHECK( c1 == c2 && k.count_out_of_bounds( n, c1.data(), lb.data(), ub.data() ) == 0 );
+
+			vector< double > dz( n ), y1( n ), y2( n );
+			k.transform_sample( n, B, a.data(), b.data(), dz.data(), y1.data() );
+			ref.transform_sample( n, B, a.data(), b.data(), dz.data(), y2.data() );
+			for ( size_t i = 0; i < n; ++i )
+				XO_CHECK( y1[i] == y2[i] );
+
+			auto C1 = C0, C2 = C0;
+			k.update_covariance( n, C1, 0.8, 0.1, 0.1, pc.data(), mu, weights.data(), steps, false );
+			ref.update_covariance( n, C2, 0.8, 0.1, 0.1, pc.data(), mu, weights.data(), steps, false );
+			for ( size_t i = 0; i < n; ++i )
+				for ( size_t j = 0; j <= i; ++j )
+					XO_CHECK( C1[i][j] == C2[i][j] );
+		}
+	}
+}
@@ -0,0 +1,74 @@
+#include "xo/system/test_case.h"
+
+#include "spot/sliding_trend.h"
+#include "xo/numerical/regression.h"
+#include "xo/container/circular_deque.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace spot
+{
+	XO_TEST_CASE( sliding_median_test )
+	{
+		std::default_random_engine eng( 123 );
+		std::uniform_int_distribution< int > dist( 0, 20 );
+		sliding_median sm;
+		std::deque< float > values;
+		for ( int i = 0; i < 500; ++i )
+		{
+			if ( values.size() == 31 || ( values.size() > 0 && i % 7 == 0 ) )
+			{
+				sm.erase( values.front() );
+				values.pop_front();
+			}
+			values.push_back( float( dist( eng ) ) );
+			sm.insert( values.back() );
+
+			vector< float > sorted( values.begin(), values.end() );
+			std::sort( sorted.begin(), sorted.end() );
+			auto n = sorted.size();
+			auto expected = n % 2 == 1 ? sorted[n / 2] : 0.5f * ( sorted[n / 2 - 1] + sorted[n / 2] );
+			XO_CHECK( sm.median() == expected );
+		}
+	}
+
+	XO_TEST_CASE( sliding_trend_test )
+	{
+		// noisy linear decrease with occasional outliers on both sides
+		std::default_random_engine eng( 123 );
+		std::normal_distribution< float > noise( 0.0f, 1.0f );
+		const size_t window = 100;
+		sliding_trend st( window );
+		xo::circular_deque< float > history;
+		history.reserve( window );
+		for ( int i = 0; i < 500; ++i )
+		{
+			float y = 1000.0f - 2.0f * i + noise( eng ) + ( i % 13 == 0 ? ( i % 2 ? 500.0f : -500.0f ) : 0.0f );
+			if ( history.full() ) history.pop_front();
+			history.push_back( y );
+			st.push_back( y );
+
+			if ( i >= 10 && i % 50 == 0 )
+			{
+				auto x0 = int( st.samples() - history.size() );
+				vector< int > x( history.size() );
+				for ( index_t j = 0; j < x.size(); ++j )
+					x[j] = x0 + int( j );
+				auto reference = xo::repeated_median_regression( x.begin(), x.end(), history.begin(), history.end() );
+				auto trend = st.trend();
+				XO_CHECK( std::abs( trend.slope() - reference.slope() ) < 0.1f );
+				XO_CHECK( std::abs( trend( float( i ) ) - reference( float( i ) ) ) < 5.0f );
+			}
+		}
+
+		// NaN samples are ignored, also when the window slides past them
+		sliding_trend nt( 4 );
+		for ( int i = 0; i < 20; ++i )
+			nt.push_back( i % 3 == 0 ? std::numeric_limits< float >::quiet_NaN() : float( i ) );
+		XO_CHECK( nt.samples() == 13 );
+		XO_CHECK( nt.size() == 4 );
+		XO_CHECK( std::isfinite( nt.trend().slope() ) );
+	}
+}
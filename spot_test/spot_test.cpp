@@ -18,6 +18,7 @@ int main( int argc, char** argv )
 		//auto [mean, stdev] = xo::mean_std( results );
 		//xo::log::info( "M=", mean, " S=", stdev );
 		//spot::compare_optimizers();
+		//spot::benchmark_migration();
 		spot::benchmark_optimizers();
 	}
 	catch ( std::exception& e )
@@ -0,0 +1,47 @@
+#include "xo/system/test_case.h"
+
+#include "spot/static_cma_optimizer.h"
+#include "spot/test_objectives.h"
+#include <cmath>
+
+namespace spot
+{
+	XO_TEST_CASE( static_cma_optimizer_test )
+	{
+		for ( int n = 1; n <= 100; ++n )
+			XO_CHECK( static_cma_default_lambda( n ) == 4 + int( 3 * std::log( double( n ) ) ) );
+		static_assert( static_cma_optimizer< 10 >::lambda == 10 );
+
+		// eigendecomposition
+		std::array< std::array< double, 3 >, 3 > a{ { { 4, 1, 0.5 }, { 1, 3, 0.2 }, { 0.5, 0.2, 2 } } }, b;
+		std::array< double, 3 > d;
+		static_symmetric_eigen< 3 >( a, d, b );
+		for ( int i = 0; i < 3; ++i )
+			for ( int j = 0; j < 3; ++j )
+			{
+				double v = 0;
+				for ( int k = 0; k < 3; ++k )
+					v += b[i][k] * d[k] * b[j][k];
+				XO_CHECK( std::abs( v - a[i][j] ) < 1e-12 );
+			}
+
+		// direct interface
+		auto himmelblau_fn = []( const std::array< double, 2 >& x ) { return himmelblau( par_vec( x.begin(), x.end() ) ); };
+		static_cma_optimizer< 2 > cma2( { 0, 0 }, { 1, 1 } );
+		cma2.run( himmelblau_fn, 1000 );
+		XO_CHECK( cma2.best_fitness() < 1e-12 );
+
+		static_cma_optimizer< 10 > cma10( {}, { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 } );
+		cma10.set_bounds( { -5, -5, -5, -5, -5, -5, -5, -5, -5, -5 }, { 5, 5, 5, 5, 5, 5, 5, 5, 5, 5 } );
+		cma10.run( []( const auto& x ) { double f = 0; for ( int i = 0; i < 10; ++i ) f += ( i + 1 ) * xo::squared( x[i] - 1 ); return f; }, 2000 );
+		XO_CHECK( cma10.best_fitness() < 1e-12 );
+
+		// optimizer interface
+		auto obj = make_himmelblau_objective();
+		sequential_evaluator eval;
+		static_cma_adapter< 2 > opt( obj, eval );
+		opt.add_stop_condition( std::make_unique< max_steps_condition >( 1000 ) );
+		opt.run();
+		XO_CHECK( opt.best_fitness() < 1e-6 );
+	}
+}
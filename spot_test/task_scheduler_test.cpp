@@ -0,0 +1,73 @@
+#include "xo/system/test_case.h"
+
+#include "spot/task_scheduler.h"
+#include "spot/pooled_evaluator.h"
+#include "spot/data_objective.h"
+#include "spot/function_objective.h"
+#include "spot/test_objectives.h"
+#include "xo/system/log.h"
+#include "xo/time/timer.h"
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace spot
+{
+	struct line_model : public data_model< 2 >
+	{
+		using data_model::data_model;
+		double operator()( double x ) const { return p[0] * x + p[1]; }
+	};
+
+	XO_TEST_CASE( task_scheduler_test )
+	{
+		auto sum = task_scheduler::current().parallel_reduce( 1000, 7, size_t( 0 ),
+			[]( size_t b, size_t e ) { size_t s = 0; for ( auto i = b; i < e; ++i ) s += i; return s; },
+			[]( size_t a, size_t b ) { return a + b; } );
+		XO_CHECK( sum == 999 * 1000 / 2 );
+
+		// idle workers run ranges of a single evaluation
+		std::mutex mutex;
+		std::set< std::thread::id > threads;
+		function_objective obj( [&]( const par_vec& v ) {
+			task_scheduler::current().parallel_for( 32, 1, [&]( size_t b, size_t e ) {
+				std::this_thread::sleep_for( 2ms );
+				std::scoped_lock lock( mutex );
+				threads.insert( std::this_thread::get_id() );
+				} );
+			return sphere( v );
+			}, 2, 0.0, 1.0, -10.0, 10.0 );
+		auto eval = pooled_evaluator( 4, xo::thread_priority::low );
+		xo::timer t;
+		auto results = eval.evaluate( obj, search_point_vec( 1, search_point( obj.info() ) ), xo::stop_token() );
+		XO_CHECK( results.front() );
+		XO_CHECK( threads.size() > 1 );
+		xo::log::info( "nested parallel_for: ", threads.size(), " threads, ", t().secondsd(), "s" );
+
+		// nested parallelism does not deadlock when all workers are busy
+		results = eval.evaluate( obj, search_point_vec( 16, search_point( obj.info() ) ), xo::stop_token() );
+		XO_CHECK( xo::count_if( results, []( const auto& r ) { return !r; } ) == 0 );
+
+		// exceptions are passed to the caller
+		function_objective throwing_obj( [&]( const par_vec& v ) {
+			task_scheduler::current().parallel_for( 32, 1, [&]( size_t b, size_t e ) { xo_error_if( b == 17, "Range error" ); } );
+			return sphere( v );
+			}, 2, 0.0, 1.0, -10.0, 10.0 );
+		results = eval.evaluate( throwing_obj, search_point_vec( 1, search_point( throwing_obj.info() ) ), xo::stop_token() );
+		XO_CHECK( !results.front() && results.front().error().message() == "Range error" );
+
+		// data_objective gives the same result with and without nested parallelism
+		data_objective< line_model >::container_t data;
+		for ( int i = 0; i < 100000; ++i )
+			data.emplace_back( 0.001 * i, 2.0 * 0.001 * i + 1.0 + 0.1 * std::sin( i ) );
+		data_objective< line_model > data_obj( std::move( data ) );
+		data_obj.set_grain_size( 1000 );
+		search_point sp( data_obj.info(), par_vec{ 1.5, 0.5 } );
+		auto pooled_result = eval.evaluate( data_obj, search_point_vec{ sp }, xo::stop_token() );
+		auto sequential_result = sequential_evaluator().evaluate( data_obj, search_point_vec{ sp }, xo::stop_token() );
+		XO_CHECK( pooled_result.front().value() == sequential_result.front().value() );
+	}
+}
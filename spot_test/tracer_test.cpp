@@ -0,0 +1,41 @@
+#include "xo/system/test_case.h"
+
+#include "spot/tracer.h"
+#include "spot/cma_optimizer.h"
+#include "spot/pooled_evaluator.h"
+#include "spot/test_objectives.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace spot
+{
+	XO_TEST_CASE( tracer_test )
+	{
+		auto obj = make_rosenbrock_objective( 4 );
+		pooled_evaluator eval( 4 );
+		cma_optimizer cma( obj, eval );
+		cma.add_stop_condition( std::make_unique< max_steps_condition >( 10 ) );
+
+		tracer::clear();
+		tracer::start();
+		cma.run();
+		tracer::stop();
+
+		auto filename = std::filesystem::temp_directory_path() / "spot_tracer_test.json";
+		tracer::write_chrome_trace( path( filename.string() ) );
+		std::ifstream str( filename );
+		std::stringstream trace;
+		trace << str.rdbuf();
+		XO_CHECK( trace.str().rfind( "{\"traceEvents\":[", 0 ) == 0 );
+
+#if defined( SPOT_TRACE_ENABLED )
+		XO_CHECK( tracer::span_count() >= 10 * ( 4 + cma.lambda() ) );
+		XO_CHECK( trace.str().find( "\"name\":\"cma_optimizer::update_distribution\"" ) != string::npos );
+		XO_CHECK( trace.str().find( "\"name\":\"evaluator::evaluate\"" ) != string::npos );
+#else
+		XO_CHECK( tracer::span_count() == 0 );
+#endif
+		std::filesystem::remove( filename );
+	}
+}